@@ -0,0 +1,32 @@
+#include "allocationcounter.hpp"
+
+#ifndef NDEBUG
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<std::uint64_t> allocations{0};
+}  // namespace
+
+// Substitui o operator new global. As formas de array e nothrow da
+// biblioteca padrao chamam esta, entao tambem sao contadas
+void *operator new(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (auto *pointer{std::malloc(size == 0 ? 1 : size)}) return pointer;
+  throw std::bad_alloc{};
+}
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::size_t) noexcept {
+  std::free(pointer);
+}
+
+bool AllocationCounter::enabled() { return true; }
+std::uint64_t AllocationCounter::count() {
+  return allocations.load(std::memory_order_relaxed);
+}
+#else
+bool AllocationCounter::enabled() { return false; }
+std::uint64_t AllocationCounter::count() { return 0; }
+#endif
@@ -0,0 +1,14 @@
+#ifndef ALLOCATIONCOUNTER_HPP_
+#define ALLOCATIONCOUNTER_HPP_
+
+#include <cstdint>
+
+// Contador de alocacoes no heap feitas pelo operator new global. So existe
+// em builds de depuracao (sem NDEBUG); em release enabled() e falso e
+// count() e sempre 0
+namespace AllocationCounter {
+[[nodiscard]] bool enabled();
+[[nodiscard]] std::uint64_t count();
+}  // namespace AllocationCounter
+
+#endif
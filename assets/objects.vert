@@ -2,14 +2,29 @@
 
 layout(location = 0) in vec2 inPosition;
 
+#ifdef INSTANCED
+// Atributos por instancia
+layout(location = 1) in vec2 inTranslation;
+layout(location = 2) in float inRotation;
+layout(location = 3) in float inScale;
+layout(location = 4) in vec4 inColor;
+#else
 uniform vec4 color;
 uniform float rotation;
 uniform float scale;
 uniform vec2 translation;
+#endif
 
 out vec4 fragColor;
 
 void main() {
+#ifdef INSTANCED
+  float rotation = inRotation;
+  float scale = inScale;
+  vec2 translation = inTranslation;
+  vec4 color = inColor;
+#endif
+
   float sinAngle = sin(rotation);
   float cosAngle = cos(rotation);
   vec2 rotated = vec2(inPosition.x * cosAngle - inPosition.y * sinAngle,
@@ -18,4 +33,4 @@ void main() {
   vec2 newPosition = rotated * scale + translation;
   gl_Position = vec4(newPosition, 0, 1);
   fragColor = color;
-}
\ No newline at end of file
+}
@@ -0,0 +1,24 @@
+#version 410
+
+in vec2 fragOffset;
+flat in vec2 fragShape;
+
+uniform vec4 color;
+
+out vec4 outColor;
+
+// Uniao de tres circulos de raio fragShape.x alinhados em x, a cada
+// fragShape.y (com fragShape.y = 0, um unico circulo)
+void main() {
+  float radius = fragShape.x;
+  vec2 spacing = vec2(fragShape.y, 0);
+
+  float distance = length(fragOffset) - radius;
+  distance = min(distance, length(fragOffset - spacing) - radius);
+  distance = min(distance, length(fragOffset + spacing) - radius);
+
+  // Antialiasing analitico: cobertura da borda dentro de um pixel
+  float coverage = clamp(0.5 - distance / fwidth(distance), 0.0, 1.0);
+  if (coverage <= 0.0) discard;
+  outColor = vec4(color.rgb, coverage);
+}
@@ -0,0 +1,15 @@
+#version 410
+
+layout(location = 0) in vec2 inPosition;
+// Centro da forma e (raio, distancia entre os circulos)
+layout(location = 1) in vec2 inCenter;
+layout(location = 2) in vec2 inShape;
+
+out vec2 fragOffset;
+flat out vec2 fragShape;
+
+void main() {
+  gl_Position = vec4(inPosition, 0, 1);
+  fragOffset = inPosition - inCenter;
+  fragShape = inShape;
+}
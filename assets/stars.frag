@@ -1,5 +1,71 @@
 #version 410
 
+#ifdef PROCEDURAL
+const int layerCount = 5;
+
+in highp vec2 fragPosition;
+
+// Por camada: (estrelas por tela, diametro em pixels, paralaxe, 0)
+uniform vec4 layers[layerCount];
+uniform highp vec2 scroll;
+uniform highp float seed;
+
+out vec4 outColor;
+
+// Hash inteiro de 3 entradas (PCG, Jarzynski e Olano 2020)
+highp uvec3 pcg3d(highp uvec3 v) {
+  v = v * 1664525u + 1013904223u;
+  v.x += v.y * v.z;
+  v.y += v.z * v.x;
+  v.z += v.x * v.y;
+  v ^= v >> 16u;
+  v.x += v.y * v.z;
+  v.y += v.z * v.x;
+  v.z += v.x * v.y;
+  return v;
+}
+
+// Cada camada divide a tela em uma grade; cada celula sorteia (pelo hash da
+// celula, da camada e da semente) se tem uma estrela, onde ela fica e o
+// brilho dela. O custo por pixel e uma celula por camada, independente do
+// numero de estrelas
+void main() {
+  // Tamanho de um pixel em coordenadas normalizadas
+  highp vec2 pixel = abs(vec2(dFdx(fragPosition.x), dFdy(fragPosition.y)));
+
+  float brightness = 0.0;
+  for (int layer = 0; layer < layerCount; ++layer) {
+    float density = layers[layer].x;
+    if (density <= 0.0) continue;
+
+    // Celulas suficientes para no maximo uma estrela por celula
+    highp float cells = ceil(sqrt(density));
+    highp vec2 cellSize = vec2(2.0 / cells);
+    highp vec2 position = fragPosition - scroll * layers[layer].z;
+    highp vec2 cell = floor(position / cellSize);
+
+    highp uvec3 hash = pcg3d(uvec3(ivec3(ivec2(cell), layer)) +
+                             uvec3(0u, 0u, uint(seed) << 3u));
+    highp vec3 random = vec3(hash) * (1.0 / 4294967295.0);
+    highp float chance = density / (cells * cells);
+    if (random.x >= chance) continue;
+
+    // O raio fica dentro da celula, para a estrela nao ser cortada
+    highp vec2 radius =
+        min(vec2(layers[layer].y * 0.5) * pixel, cellSize * 0.45);
+    highp vec2 center = (cell + 0.5) * cellSize +
+                        (random.yz - 0.5) * (cellSize - 2.0 * radius);
+    float falloff = 1.0 - length((position - center) / radius);
+
+    // Mesmo brilho dos pontos: de 0.5 a 1, com queda linear ate a borda
+    float intensity = mix(0.5, 1.0, random.x / chance);
+    brightness += intensity * max(falloff, 0.0);
+  }
+
+  if (brightness <= 0.0) discard;
+  outColor = vec4(brightness);
+}
+#else
 in vec4 fragColor;
 
 out vec4 outColor;
@@ -7,4 +73,5 @@ out vec4 outColor;
 void main() {
   float intensity = 1.0 - length(gl_PointCoord - vec2(0.5)) * 2.0;
   outColor = fragColor * intensity;
-}
\ No newline at end of file
+}
+#endif
@@ -1,15 +1,34 @@
 #version 410
 
+#ifdef PROCEDURAL
+out vec2 fragPosition;
+
+void main() {
+  // Triangulo que cobre a tela inteira, sem atributos de vertice
+  vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2) * 2.0 - 1.0;
+  gl_Position = vec4(position, 0, 1);
+  fragPosition = position;
+}
+#else
+// z: indice da camada (0 e a mais proxima)
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inColor;
 
-uniform vec2 translation;
+uniform vec2 scroll;
 uniform float pointSize;
 
 out vec4 fragColor;
 
 void main() {
-  gl_PointSize = pointSize;
-  gl_Position = vec4(inPosition.xy + translation, 0, 1);
+  // Paralaxe: camadas mais distantes rolam mais devagar
+  float depth = 1.0 + inPosition.z;
+  vec2 position = inPosition.xy + scroll / depth;
+
+  // Repete o campo [-1, 1] nas duas direcoes
+  position = mod(position + 1.0, 2.0) - 1.0;
+
+  gl_PointSize = pointSize / depth;
+  gl_Position = vec4(position, 0, 1);
   fragColor = vec4(inColor, 1);
-}
\ No newline at end of file
+}
+#endif
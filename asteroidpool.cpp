@@ -0,0 +1,117 @@
+#include "asteroidpool.hpp"
+
+AsteroidHandle AsteroidPool::add(glm::vec2 translation, glm::vec2 velocity,
+                                 float angularVelocity, float scale,
+                                 float intensity, int shapeIndex) {
+  // Reaproveita um slot livre ou cria um novo
+  std::uint32_t slot{};
+  if (m_freeSlots.empty()) {
+    slot = static_cast<std::uint32_t>(m_slotToDense.size());
+    m_slotToDense.push_back(0);
+    m_generations.push_back(0);
+  } else {
+    slot = m_freeSlots.back();
+    m_freeSlots.pop_back();
+  }
+
+  m_slotToDense[slot] = static_cast<std::uint32_t>(size());
+  m_denseToSlot.push_back(slot);
+
+  m_translations.push_back(translation);
+  m_velocities.push_back(velocity);
+  m_rotations.push_back(0.0f);
+  m_angularVelocities.push_back(angularVelocity);
+  m_scales.push_back(scale);
+  m_intensities.push_back(intensity);
+  m_shapeIndices.push_back(shapeIndex);
+  m_previousTranslations.push_back(translation);
+  m_previousRotations.push_back(0.0f);
+
+  return AsteroidHandle{slot, m_generations[slot]};
+}
+
+// Remove o asteroide do indice denso dado movendo o ultimo para o seu lugar
+void AsteroidPool::remove(std::size_t index) {
+  const auto last{size() - 1};
+  const auto slot{m_denseToSlot[index]};
+
+  if (index != last) {
+    m_translations[index] = m_translations[last];
+    m_velocities[index] = m_velocities[last];
+    m_rotations[index] = m_rotations[last];
+    m_angularVelocities[index] = m_angularVelocities[last];
+    m_scales[index] = m_scales[last];
+    m_intensities[index] = m_intensities[last];
+    m_shapeIndices[index] = m_shapeIndices[last];
+    m_previousTranslations[index] = m_previousTranslations[last];
+    m_previousRotations[index] = m_previousRotations[last];
+
+    m_denseToSlot[index] = m_denseToSlot[last];
+    m_slotToDense[m_denseToSlot[index]] = static_cast<std::uint32_t>(index);
+  }
+
+  m_translations.pop_back();
+  m_velocities.pop_back();
+  m_rotations.pop_back();
+  m_angularVelocities.pop_back();
+  m_scales.pop_back();
+  m_intensities.pop_back();
+  m_shapeIndices.pop_back();
+  m_previousTranslations.pop_back();
+  m_previousRotations.pop_back();
+  m_denseToSlot.pop_back();
+
+  // Invalida handles antigos para este slot
+  ++m_generations[slot];
+  m_freeSlots.push_back(slot);
+}
+
+bool AsteroidPool::remove(AsteroidHandle handle) {
+  const auto index{indexOf(handle)};
+  if (index == npos) return false;
+  remove(index);
+  return true;
+}
+
+void AsteroidPool::clear() {
+  while (!empty()) {
+    remove(size() - 1);
+  }
+}
+
+void AsteroidPool::reserve(std::size_t capacity) {
+  m_translations.reserve(capacity);
+  m_velocities.reserve(capacity);
+  m_rotations.reserve(capacity);
+  m_angularVelocities.reserve(capacity);
+  m_scales.reserve(capacity);
+  m_intensities.reserve(capacity);
+  m_shapeIndices.reserve(capacity);
+  m_previousTranslations.reserve(capacity);
+  m_previousRotations.reserve(capacity);
+  m_denseToSlot.reserve(capacity);
+  m_slotToDense.reserve(capacity);
+  m_generations.reserve(capacity);
+  m_freeSlots.reserve(capacity);
+}
+
+// Guarda o estado atual como o do passo anterior (inicio de cada passo)
+void AsteroidPool::storePrevious() {
+  m_previousTranslations = m_translations;
+  m_previousRotations = m_rotations;
+}
+
+bool AsteroidPool::contains(AsteroidHandle handle) const {
+  return handle.m_slot < m_generations.size() &&
+         m_generations[handle.m_slot] == handle.m_generation;
+}
+
+std::size_t AsteroidPool::indexOf(AsteroidHandle handle) const {
+  if (!contains(handle)) return npos;
+  return m_slotToDense[handle.m_slot];
+}
+
+AsteroidHandle AsteroidPool::handleAt(std::size_t index) const {
+  const auto slot{m_denseToSlot[index]};
+  return AsteroidHandle{slot, m_generations[slot]};
+}
@@ -0,0 +1,71 @@
+#ifndef ASTEROIDPOOL_HPP_
+#define ASTEROIDPOOL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+// Referencia estavel a um asteroide do AsteroidPool. Continua valida mesmo
+// quando o asteroide muda de posicao nos arrays densos; deixa de ser valida
+// (contains() retorna false) assim que o asteroide e removido
+struct AsteroidHandle {
+  std::uint32_t m_slot{UINT32_MAX};
+  std::uint32_t m_generation{};
+};
+
+// Armazenamento struct-of-arrays dos asteroides. Os arrays publicos sao
+// densos e contiguos (indices 0..size()-1); remover um asteroide move o
+// ultimo para o lugar dele (swap-and-pop). Depois do reserve(), adicionar e
+// remover nao alocam memoria
+class AsteroidPool {
+ public:
+  static constexpr std::size_t npos{SIZE_MAX};
+
+  AsteroidHandle add(glm::vec2 translation, glm::vec2 velocity,
+                     float angularVelocity, float scale, float intensity,
+                     int shapeIndex);
+  void remove(std::size_t index);
+  bool remove(AsteroidHandle handle);
+  void clear();
+  void reserve(std::size_t capacity);
+
+  [[nodiscard]] bool contains(AsteroidHandle handle) const;
+  [[nodiscard]] std::size_t indexOf(AsteroidHandle handle) const;
+  [[nodiscard]] AsteroidHandle handleAt(std::size_t index) const;
+  [[nodiscard]] std::size_t indexOfSlot(std::uint32_t slot) const {
+    return m_slotToDense[slot];
+  }
+
+  [[nodiscard]] std::size_t size() const { return m_translations.size(); }
+  [[nodiscard]] bool empty() const { return m_translations.empty(); }
+
+  std::vector<glm::vec2> m_translations;
+  std::vector<glm::vec2> m_velocities;
+  std::vector<float> m_rotations;
+  std::vector<float> m_angularVelocities;
+  std::vector<float> m_scales;
+  std::vector<float> m_intensities;
+  std::vector<int> m_shapeIndices;
+
+  // Estado do passo anterior da simulacao, usado para interpolar o desenho
+  std::vector<glm::vec2> m_previousTranslations;
+  std::vector<float> m_previousRotations;
+
+  void storePrevious();
+  [[nodiscard]] glm::vec2 interpolatedTranslation(std::size_t index,
+                                                  float alpha) const {
+    return m_previousTranslations[index] +
+           (m_translations[index] - m_previousTranslations[index]) * alpha;
+  }
+
+ private:
+  // Tabela de indirecao slot <-> indice denso
+  std::vector<std::uint32_t> m_denseToSlot;
+  std::vector<std::uint32_t> m_slotToDense;
+  std::vector<std::uint32_t> m_generations;
+  std::vector<std::uint32_t> m_freeSlots;
+};
+
+#endif
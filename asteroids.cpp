@@ -1,134 +1,135 @@
 #include "asteroids.hpp"
 
 #include <cppitertools/itertools.hpp>
-#include <glm/gtx/fast_trigonometry.hpp>
+#include <cstddef>
 
-void Asteroids::initializeGL(GLuint program, int quantity) {
+void Asteroids::initializeGL(GLuint program, GLuint instancedProgram,
+                             const AsteroidShapes &shapes) {
   terminateGL();
 
-  //Inicia um gerador de numeros pseudo-aleatórios
-  m_randomEngine.seed(
-      std::chrono::steady_clock::now().time_since_epoch().count());
-
   m_program = program;
   m_colorLoc = abcg::glGetUniformLocation(m_program, "color");
   m_rotationLoc = abcg::glGetUniformLocation(m_program, "rotation");
   m_scaleLoc = abcg::glGetUniformLocation(m_program, "scale");
   m_translationLoc = abcg::glGetUniformLocation(m_program, "translation");
+  m_instancedProgram = instancedProgram;
 
-  // Cria asteroids
-  m_asteroids.clear();
-  m_asteroids.resize(quantity);
-
-  for (auto &asteroid : m_asteroids) {
-    asteroid = createAsteroid(glm::vec2{m_randomDist(m_randomEngine), 1});
-  }
+  // Envia a biblioteca de formatos compartilhada por todos os asteroids
+  createShapes(shapes);
 }
 
-void Asteroids::paintGL() {
-  abcg::glUseProgram(m_program);
-
-  for (const auto &asteroid : m_asteroids) {
-    abcg::glBindVertexArray(asteroid.m_vao);
-
-    abcg::glUniform4fv(m_colorLoc, 1, &asteroid.m_color.r);
-    abcg::glUniform1f(m_scaleLoc, asteroid.m_scale);
-    abcg::glUniform1f(m_rotationLoc, asteroid.m_rotation);
-
-    abcg::glUniform2f(m_translationLoc, asteroid.m_translation.x,
-                      asteroid.m_translation.y);
-
-    abcg::glDrawArrays(GL_TRIANGLE_FAN, 0, asteroid.m_polygonSides + 2);
-
-    abcg::glBindVertexArray(0);
+void Asteroids::paintGL(const AsteroidPool &asteroids, float alpha,
+                        StreamBuffer &stream, RenderQueue &queue) {
+  if (m_instanced) {
+    paintInstanced(asteroids, alpha, stream, queue);
+    return;
   }
 
-  abcg::glUseProgram(0);
-}
-
-void Asteroids::terminateGL() {
-  for (auto asteroid : m_asteroids) {
-    abcg::glDeleteBuffers(1, &asteroid.m_vbo);
-    abcg::glDeleteVertexArrays(1, &asteroid.m_vao);
+  for (const auto index : iter::range(asteroids.size())) {
+    const auto color{m_color_asteroids * asteroids.m_intensities[index]};
+    const auto translation{asteroids.interpolatedTranslation(index, alpha)};
+    const auto rotation{interpolateAngle(asteroids.m_previousRotations[index],
+                                         asteroids.m_rotations[index], alpha)};
+    const auto &shape{m_shapes[asteroids.m_shapeIndices[index]]};
+
+    auto &packet{
+        queue.submit(RenderQueue::Layer::Asteroids, m_program, m_vao)};
+    packet.m_mode = GL_TRIANGLE_FAN;
+    packet.m_first = shape.m_first;
+    packet.m_count = shape.m_count;
+    queue.uniform(m_colorLoc, color);
+    queue.uniform(m_scaleLoc, asteroids.m_scales[index]);
+    queue.uniform(m_rotationLoc, rotation);
+    queue.uniform(m_translationLoc, translation);
   }
 }
 
-// Atualizacao dos asteroids (girar e se mover na tela)
-void Asteroids::update(float deltaTime, int *m_pedras_desviados_pointer) {
-  for (auto &asteroid : m_asteroids) {
-    asteroid.m_rotation = glm::wrapAngle(
-        asteroid.m_rotation + asteroid.m_angularVelocity * deltaTime);
-    asteroid.m_translation += asteroid.m_velocity * deltaTime;
-
-    if (asteroid.m_translation.y < -(1.0f + asteroid.m_scale) ||
-        asteroid.m_translation.y > (1.0f + asteroid.m_scale)) {
-      asteroid.m_hit = 1;
-      *(m_pedras_desviados_pointer) += 1;
-    }
+// Desenha todos os asteroids com um glDrawArraysInstanced por formato. As
+// instancias sao agrupadas por formato (counting sort) e escritas direto na
+// fatia do buffer de streaming deste quadro
+void Asteroids::paintInstanced(const AsteroidPool &asteroids, float alpha,
+                               StreamBuffer &stream, RenderQueue &queue) {
+  if (asteroids.empty()) return;
+
+  // Conta instancias por formato e calcula o inicio de cada grupo
+  m_shapeInstanceCounts.assign(m_shapes.size() + 1, 0);
+  for (const auto shapeIndex : asteroids.m_shapeIndices) {
+    ++m_shapeInstanceCounts[shapeIndex + 1];
+  }
+  for (const auto index : iter::range(1, static_cast<int>(m_shapes.size()))) {
+    m_shapeInstanceCounts[index + 1] += m_shapeInstanceCounts[index];
   }
-}
-
-// Criando asteroids com posição, constante de velocidade inversa, ordenacao
-// (cima ou baixo) e escala
-Asteroids::Asteroid Asteroids::createAsteroid(glm::vec2 translation,
-                                              float inverse_velocity,
-                                              int ordenation, float scale) {
-  Asteroid asteroid;
-
-  auto &re{m_randomEngine};  
-
-  // Escolher numero de lados aleatoriamente
-  std::uniform_int_distribution<int> randomSides(8, 10);
-  asteroid.m_polygonSides = randomSides(re);
-
-  // Escolher uma cor aleatoria na escala
-  std::uniform_real_distribution<float> randomIntensity{0.6f, 0.9f};
-  asteroid.m_color = m_color_asteroids * randomIntensity(re);
-
-  asteroid.m_rotation = 0.0f;
-  asteroid.m_scale = scale;
-  asteroid.m_translation = translation;
-
-  // Velocidade angular aleatoria
-  asteroid.m_angularVelocity = m_randomDist(re);
 
-  // Direção aleatoria
-  glm::vec2 direction{0, -1};
+  // Preenche as instancias ja agrupadas na memoria mapeada
+  const auto slice{stream.map(
+      static_cast<GLsizeiptr>(asteroids.size() * sizeof(Instance)),
+      alignof(Instance))};
+  auto *instances{static_cast<Instance *>(slice.m_data)};
+  for (const auto index : iter::range(asteroids.size())) {
+    const auto shapeIndex{asteroids.m_shapeIndices[index]};
+    auto &instance{instances[m_shapeInstanceCounts[shapeIndex]++]};
+    instance.m_translation = asteroids.interpolatedTranslation(index, alpha);
+    instance.m_rotation = interpolateAngle(
+        asteroids.m_previousRotations[index], asteroids.m_rotations[index],
+        alpha);
+    instance.m_scale = asteroids.m_scales[index];
+    instance.m_color = m_color_asteroids * asteroids.m_intensities[index];
+  }
 
-  if (ordenation) {
-    direction.y = 1;
+  stream.unmap();
+
+  // Depois do preenchimento, m_shapeInstanceCounts[i] marca o fim do grupo i
+  GLsizei groupStart{0};
+  for (auto &&[index, shape] : iter::enumerate(m_shapes)) {
+    const auto groupEnd{m_shapeInstanceCounts[index]};
+    const auto instanceCount{groupEnd - groupStart};
+    if (instanceCount > 0) {
+      auto &packet{queue.submit(RenderQueue::Layer::Asteroids,
+                                m_instancedProgram, m_instancedVao)};
+      packet.m_mode = GL_TRIANGLE_FAN;
+      packet.m_first = shape.m_first;
+      packet.m_count = shape.m_count;
+      packet.m_instances = instanceCount;
+      // Os atributos por instancia apontam para o inicio do grupo
+      packet.m_instanceLayout = &m_instanceLayout;
+      packet.m_instanceBuffer = slice.m_buffer;
+      packet.m_instanceOffset =
+          slice.m_offset + static_cast<GLintptr>(groupStart * sizeof(Instance));
+    }
+    groupStart = groupEnd;
   }
+}
 
-  asteroid.m_velocity = glm::normalize(direction) / inverse_velocity;
+void Asteroids::terminateGL() {
+  m_vbo.reset();
+  m_vao.reset();
+  m_instancedVao.reset();
+  m_shapes.clear();
+}
 
-  // Criar geometria
-  std::vector<glm::vec2> positions(0);
-  positions.emplace_back(0, 0);
-  const auto step{M_PI * 2 / asteroid.m_polygonSides};
-  std::uniform_real_distribution<float> randomRadius(0.6f, 0.8f);
-  for (const auto angle : iter::range(0.0, M_PI * 2, step)) {
-    const auto radius{randomRadius(re)};
-    positions.emplace_back(radius * std::cos(angle), radius * std::sin(angle));
-  }
-  positions.push_back(positions.at(1));
+// Envia a biblioteca de formatos para um unico VBO. Cada formato e desenhado
+// como um GL_TRIANGLE_FAN a partir de m_first
+void Asteroids::createShapes(const AsteroidShapes &shapes) {
+  m_shapes = shapes.m_shapes;
+  const auto &positions{shapes.m_positions};
 
   // Criar VBO
-  abcg::glGenBuffers(1, &asteroid.m_vbo);
-  abcg::glBindBuffer(GL_ARRAY_BUFFER, asteroid.m_vbo);
-  abcg::glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec2),
-                     positions.data(), GL_STATIC_DRAW);
+  m_vbo = GLBuffer{GLResourceRegistry::Owner::Asteroids};
+  abcg::glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+  bufferData(m_vbo, GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec2),
+             positions.data(), GL_STATIC_DRAW);
   abcg::glBindBuffer(GL_ARRAY_BUFFER, 0);
 
   // Pegar localizacao dos atributos
   GLint positionAttribute{abcg::glGetAttribLocation(m_program, "inPosition")};
 
   // Criar VAO
-  abcg::glGenVertexArrays(1, &asteroid.m_vao);
+  m_vao = GLVertexArray{GLResourceRegistry::Owner::Asteroids};
 
   // Vincular atributos de vértice ao VAO atual
-  abcg::glBindVertexArray(asteroid.m_vao);
+  abcg::glBindVertexArray(m_vao);
 
-  abcg::glBindBuffer(GL_ARRAY_BUFFER, asteroid.m_vbo);
+  abcg::glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
   abcg::glEnableVertexAttribArray(positionAttribute);
   abcg::glVertexAttribPointer(positionAttribute, 2, GL_FLOAT, GL_FALSE, 0,
                               nullptr);
@@ -137,5 +138,27 @@ Asteroids::Asteroid Asteroids::createAsteroid(glm::vec2 translation,
   //  Fim da ligação ao VAO atual
   abcg::glBindVertexArray(0);
 
-  return asteroid;
+  // VAO do modo instanciado: mesmo VBO de formatos no atributo 0 e atributos
+  // por instancia (1 a 4) lidos do buffer de streaming. Os ponteiros dos
+  // atributos por instancia sao definidos pela RenderQueue em cada draw
+  m_instancedVao = GLVertexArray{GLResourceRegistry::Owner::Asteroids};
+
+  abcg::glBindVertexArray(m_instancedVao);
+
+  abcg::glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+  abcg::glEnableVertexAttribArray(0);
+  abcg::glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+  for (const GLuint attribute : {1, 2, 3, 4}) {
+    abcg::glEnableVertexAttribArray(attribute);
+    abcg::glVertexAttribDivisor(attribute, 1);
+  }
+  m_instanceLayout = {sizeof(Instance),
+                      {{1, 2, offsetof(Instance, m_translation)},
+                       {2, 1, offsetof(Instance, m_rotation)},
+                       {3, 1, offsetof(Instance, m_scale)},
+                       {4, 4, offsetof(Instance, m_color)}}};
+  abcg::glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  abcg::glBindVertexArray(0);
 }
@@ -1,23 +1,28 @@
 #ifndef ASTEROIDS_HPP_
 #define ASTEROIDS_HPP_
 
-#include <list>
-#include <random>
+#include <vector>
 
 #include "abcg.hpp"
-#include "cat.hpp"
-#include "gamedata.hpp"
+#include "asteroidpool.hpp"
+#include "asteroidshapes.hpp"
+#include "glresource.hpp"
+#include "renderqueue.hpp"
+#include "simulation.hpp"
+#include "streambuffer.hpp"
 
 class OpenGLWindow;
 
 class Asteroids {
  public:
-  void initializeGL(GLuint program, int quantity);
-  void paintGL();
+  void initializeGL(GLuint program, GLuint instancedProgram,
+                    const AsteroidShapes &shapes);
+  // alpha: fracao entre o passo anterior e o atual da simulacao. No modo
+  // instanciado, as instancias sao escritas no buffer de streaming
+  void paintGL(const AsteroidPool &asteroids, float alpha,
+               StreamBuffer &stream, RenderQueue &queue);
   void terminateGL();
 
-  void update(float deltaTime, int* m_asteroids_desviados_pointer);
-
  private:
   friend OpenGLWindow;
 
@@ -28,28 +33,33 @@ class Asteroids {
   GLint m_scaleLoc{};
   glm::vec4 m_color_asteroids{1};
 
-  struct Asteroid {
-    GLuint m_vao{};
-    GLuint m_vbo{};
+  // Modo instanciado: um glDrawArraysInstanced por formato da biblioteca
+  bool m_instanced{true};
+  GLuint m_instancedProgram{};
+  GLVertexArray m_instancedVao;
 
-    float m_angularVelocity{};
-    glm::vec4 m_color{1};
-    bool m_hit{false};
-    int m_polygonSides{};
+  struct Instance {
+    glm::vec2 m_translation{};
     float m_rotation{};
     float m_scale{};
-    glm::vec2 m_translation{glm::vec2(0)};
-    glm::vec2 m_velocity{glm::vec2(0)};
+    glm::vec4 m_color{};
   };
 
-  std::list<Asteroid> m_asteroids;
+  std::vector<GLsizei> m_shapeInstanceCounts;
+  // Atributos 1 a 4 do VAO instanciado, lidos de cada grupo na fatia do quadro
+  InstanceLayout m_instanceLayout;
+
+  // Biblioteca de formatos (gerada pela Simulation): todos os poligonos
+  // ficam em um unico VBO/VAO, criado no initializeGL, e cada asteroide
+  // guarda apenas o indice do formato que usa
+  GLVertexArray m_vao;
+  GLBuffer m_vbo;
 
-  std::default_random_engine m_randomEngine;
-  std::uniform_real_distribution<float> m_randomDist{-1.0f, 1.0f};
+  std::vector<AsteroidShapes::Shape> m_shapes;
 
-  Asteroids::Asteroid createAsteroid(glm::vec2 translation = glm::vec2(0),
-                                     float inverse_velocity = 7.0f,
-                                     int ordenation = 0, float scale = 0.25f);
+  void createShapes(const AsteroidShapes &shapes);
+  void paintInstanced(const AsteroidPool &asteroids, float alpha,
+                      StreamBuffer &stream, RenderQueue &queue);
 };
 
 #endif
\ No newline at end of file
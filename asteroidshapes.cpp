@@ -0,0 +1,31 @@
+#include "asteroidshapes.hpp"
+
+#include <cmath>
+
+void AsteroidShapes::generate(std::default_random_engine &re, int quantity) {
+  std::uniform_int_distribution<int> randomSides(8, 10);
+  std::uniform_real_distribution<float> randomRadius(0.6f, 0.8f);
+
+  m_positions.clear();
+  m_shapes.clear();
+  m_shapes.reserve(quantity);
+
+  for (int i{0}; i < quantity; ++i) {
+    Shape shape;
+    shape.m_first = static_cast<int>(m_positions.size());
+
+    const auto polygonSides{randomSides(re)};
+    m_positions.emplace_back(0, 0);
+    const auto step{M_PI * 2 / polygonSides};
+    for (int side{0}; side < polygonSides; ++side) {
+      const auto angle{step * side};
+      const auto radius{randomRadius(re)};
+      m_positions.emplace_back(radius * std::cos(angle),
+                               radius * std::sin(angle));
+    }
+    m_positions.push_back(m_positions.at(shape.m_first + 1));
+
+    shape.m_count = static_cast<int>(m_positions.size()) - shape.m_first;
+    m_shapes.push_back(shape);
+  }
+}
@@ -0,0 +1,26 @@
+#ifndef ASTEROIDSHAPES_HPP_
+#define ASTEROIDSHAPES_HPP_
+
+#include <random>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+// Biblioteca de formatos de asteroides: poligonos aleatorios de 8 a 10 lados
+// empacotados em um unico array de vertices. Cada formato e um triangle fan
+// que comeca em m_first e tem m_count vertices
+struct AsteroidShapes {
+  struct Shape {
+    int m_first{};
+    int m_count{};
+  };
+
+  std::vector<glm::vec2> m_positions;
+  std::vector<Shape> m_shapes;
+
+  void generate(std::default_random_engine &re, int quantity);
+
+  [[nodiscard]] int size() const { return static_cast<int>(m_shapes.size()); }
+};
+
+#endif
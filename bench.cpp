@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "overlapkernel.hpp"
+#include "simulation.hpp"
+
+// Acesso aos passos internos da Simulation (declarado friend em
+// simulation.hpp)
+struct SimulationBenchmark {
+  static void updateAsteroids(Simulation &simulation, float deltaTime) {
+    simulation.updateAsteroids(deltaTime);
+  }
+  static void checkCollisions(Simulation &simulation) {
+    simulation.checkCollisions();
+  }
+  static void createAsteroid(Simulation &simulation, glm::vec2 translation) {
+    simulation.createAsteroid(translation);
+  }
+};
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct Result {
+  std::string m_name;
+  long m_count{};
+  long m_iterations{};
+  double m_nsPerIteration{};
+  double m_nsPerEntity{};
+};
+
+// Repete fn ate somar pelo menos minTime segundos (e ao menos 3 vezes)
+Result measure(const std::string &name, long count,
+               const std::function<void()> &fn, double minTime = 0.2) {
+  fn();  // aquecimento
+
+  long iterations{0};
+  double elapsed{0.0};
+  const auto start{Clock::now()};
+  while (iterations < 3 || elapsed < minTime) {
+    fn();
+    ++iterations;
+    elapsed = std::chrono::duration<double>{Clock::now() - start}.count();
+  }
+
+  const auto nsPerIteration{elapsed * 1e9 / static_cast<double>(iterations)};
+  return Result{name, count, iterations, nsPerIteration,
+                nsPerIteration / static_cast<double>(count)};
+}
+
+// Simulacao com count asteroides espalhados pelo campo. As posicoes ficam
+// longe das bordas para que nenhum saia da tela durante a medicao
+void populate(Simulation &simulation, long count) {
+  simulation.initialize(42);
+  simulation.m_asteroids.reserve(static_cast<std::size_t>(count));
+
+  std::default_random_engine re{7};
+  std::uniform_real_distribution<float> randomPosition{-0.7f, 0.7f};
+  while (simulation.m_asteroids.size() < static_cast<std::size_t>(count)) {
+    SimulationBenchmark::createAsteroid(
+        simulation, glm::vec2{randomPosition(re), randomPosition(re)});
+  }
+}
+
+void benchUpdateAsteroids(std::vector<Result> &results, long count) {
+  Simulation simulation;
+  populate(simulation, count);
+
+  // Um passo para frente e outro para tras: os asteroides voltam para onde
+  // estavam e o numero de entidades fica constante
+  const auto deltaTime{simulation.fixedDeltaTime()};
+  auto result{measure("Simulation::updateAsteroids", count, [&] {
+    SimulationBenchmark::updateAsteroids(simulation, deltaTime);
+    SimulationBenchmark::updateAsteroids(simulation, -deltaTime);
+  })};
+  result.m_nsPerIteration /= 2.0;
+  result.m_nsPerEntity /= 2.0;
+  result.m_iterations *= 2;
+  results.push_back(result);
+}
+
+void benchCheckCollisions(std::vector<Result> &results, long count) {
+  Simulation simulation;
+  populate(simulation, count);
+
+  results.push_back(measure("Simulation::checkCollisions", count, [&] {
+    SimulationBenchmark::checkCollisions(simulation);
+  }));
+}
+
+// Kernel de sobreposicao isolado, em cada caminho suportado pela CPU
+void benchOverlapKernel(std::vector<Result> &results, long count) {
+  Simulation simulation;
+  populate(simulation, count);
+  const auto &asteroids{simulation.m_asteroids};
+  std::vector<std::uint64_t> hits(overlapMaskWords(asteroids.size()));
+
+  for (const auto path : {SimdPath::Scalar, SimdPath::Sse2, SimdPath::Avx2}) {
+    if (!simdPathSupported(path)) continue;
+    results.push_back(measure(
+        std::string{"overlapCircles/"} + simdPathName(path), count, [&] {
+          overlapCircles(glm::vec2{0.0f}, 0.125f * 0.9f,
+                         asteroids.m_translations.data(),
+                         asteroids.m_scales.data(), 0.85f, asteroids.size(),
+                         hits.data(), path);
+        }));
+  }
+}
+
+void benchCreateShapes(std::vector<Result> &results, long count) {
+  std::default_random_engine re{42};
+  AsteroidShapes shapes;
+
+  results.push_back(measure("AsteroidShapes::generate", count, [&] {
+    shapes.generate(re, static_cast<int>(count));
+  }));
+}
+
+void benchCreateAsteroid(std::vector<Result> &results, long count) {
+  Simulation simulation;
+  simulation.initialize(42);
+  simulation.m_asteroids.reserve(static_cast<std::size_t>(count));
+
+  results.push_back(measure("Simulation::createAsteroid", count, [&] {
+    simulation.m_asteroids.clear();
+    simulation.m_grid.clear();
+    for (long i{0}; i < count; ++i) {
+      SimulationBenchmark::createAsteroid(simulation, glm::vec2{0.0f});
+    }
+  }));
+}
+
+// Restart com count asteroides vivos. Cada restart precisa de um campo
+// cheio, entao so o restart() e cronometrado. O restart da janela, com as
+// estrelas e o primeiro quadro, e medido no teste de renderizacao
+void benchRestart(std::vector<Result> &results, long count) {
+  Simulation simulation;
+  populate(simulation, count);
+
+  long iterations{0};
+  double elapsed{0.0};
+  while (iterations < 3 || elapsed < 0.2) {
+    while (simulation.m_asteroids.size() < static_cast<std::size_t>(count)) {
+      SimulationBenchmark::createAsteroid(simulation, glm::vec2{0.0f});
+    }
+
+    const auto start{Clock::now()};
+    simulation.restart();
+    elapsed += std::chrono::duration<double>{Clock::now() - start}.count();
+    ++iterations;
+  }
+
+  const auto nsPerIteration{elapsed * 1e9 / static_cast<double>(iterations)};
+  results.push_back(Result{"Simulation::restart", count, iterations,
+                           nsPerIteration,
+                           nsPerIteration / static_cast<double>(count)});
+}
+
+void benchCatUpdate(std::vector<Result> &results, long count) {
+  std::vector<CatState> cats(static_cast<std::size_t>(count));
+  GameData gameData;
+  gameData.m_input.set(static_cast<std::size_t>(Input::Right));
+  gameData.m_input.set(static_cast<std::size_t>(Input::Up));
+
+  // Alterna o sentido do passo para que os gatos nao parem nas bordas
+  float deltaTime{1.0f / 120.0f};
+  results.push_back(measure("CatState::update", count, [&] {
+    for (auto &cat : cats) {
+      cat.update(gameData, deltaTime);
+    }
+    deltaTime = -deltaTime;
+  }));
+}
+
+void writeJson(std::FILE *file, const std::vector<Result> &results) {
+  std::fprintf(file, "{\n  \"benchmarks\": [\n");
+  for (std::size_t i{0}; i < results.size(); ++i) {
+    const auto &result{results[i]};
+    std::fprintf(file,
+                 "    {\"name\": \"%s\", \"count\": %ld, \"iterations\": %ld, "
+                 "\"ns_per_iteration\": %.3f, \"ns_per_entity\": %.3f}%s\n",
+                 result.m_name.c_str(), result.m_count, result.m_iterations,
+                 result.m_nsPerIteration, result.m_nsPerEntity,
+                 i + 1 < results.size() ? "," : "");
+  }
+  std::fprintf(file, "  ]\n}\n");
+}
+}  // namespace
+
+// Microbenchmarks dos caminhos quentes da simulacao, de 10 a 1M entidades.
+// Uso: catrun_bench [arquivo.json] [maximo de entidades]
+// Sem arquivo, o JSON e escrito na saida padrao
+int main(int argc, char **argv) {
+  const std::string path{argc > 1 ? argv[1] : "-"};
+  const auto maxCount{argc > 2 ? std::stol(argv[2]) : 1000000L};
+
+  std::fprintf(stderr, "overlap kernel: %s\n", simdPathName(bestSimdPath()));
+
+  std::vector<Result> results;
+  for (long count{10}; count <= maxCount; count *= 10) {
+    std::fprintf(stderr, "%ld entities...\n", count);
+    benchUpdateAsteroids(results, count);
+    benchCheckCollisions(results, count);
+    benchOverlapKernel(results, count);
+    benchCreateShapes(results, count);
+    benchCreateAsteroid(results, count);
+    benchCatUpdate(results, count);
+    benchRestart(results, count);
+  }
+
+  if (path == "-") {
+    writeJson(stdout, results);
+    return 0;
+  }
+
+  auto *file{std::fopen(path.c_str(), "w")};
+  if (file == nullptr) {
+    std::fprintf(stderr, "could not write %s\n", path.c_str());
+    return 1;
+  }
+  writeJson(file, results);
+  std::fclose(file);
+  return 0;
+}
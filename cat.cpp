@@ -1,6 +1,5 @@
 #include "cat.hpp"
 
-#include <glm/gtx/fast_trigonometry.hpp>
 #include <glm/gtx/rotate_vector.hpp>
 
 // Criação do gato
@@ -14,10 +13,6 @@ void Cat::initializeGL(GLuint program) {
   m_scaleLoc = abcg::glGetUniformLocation(m_program, "scale");
   m_translationLoc = abcg::glGetUniformLocation(m_program, "translation");
 
-  m_rotation = 0.0f;
-  m_translation = glm::vec2(0);
-  m_velocity = glm::vec2(0);
-
   std::array<glm::vec2, 32> positions{
       //Corpo do gato
       glm::vec2{-15.00f, +15.00f}, glm::vec2{-10.00f, +10.00f},
@@ -57,24 +52,24 @@ void Cat::initializeGL(GLuint program) {
 
 
   // Criar VBO
-  abcg::glGenBuffers(1, &m_vbo);
+  m_vbo = GLBuffer{GLResourceRegistry::Owner::Cat};
   abcg::glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-  abcg::glBufferData(GL_ARRAY_BUFFER, sizeof(positions), positions.data(),
-                     GL_STATIC_DRAW);
+  bufferData(m_vbo, GL_ARRAY_BUFFER, sizeof(positions), positions.data(),
+             GL_STATIC_DRAW);
   abcg::glBindBuffer(GL_ARRAY_BUFFER, 0);
 
   // Criar EBO
-  abcg::glGenBuffers(1, &m_ebo);
+  m_ebo = GLBuffer{GLResourceRegistry::Owner::Cat};
   abcg::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
-  abcg::glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices.data(),
-                     GL_STATIC_DRAW);
+  bufferData(m_ebo, GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices.data(),
+             GL_STATIC_DRAW);
   abcg::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
   // Pegar localizacao dos atributos no programa
   GLint positionAttribute{abcg::glGetAttribLocation(m_program, "inPosition")};
 
   // Criar VAO
-  abcg::glGenVertexArrays(1, &m_vao);
+  m_vao = GLVertexArray{GLResourceRegistry::Owner::Cat};
 
   // Vincular atributos de vértice ao VAO atual
   abcg::glBindVertexArray(m_vao);
@@ -91,43 +86,26 @@ void Cat::initializeGL(GLuint program) {
   abcg::glBindVertexArray(0);
 }
 
-void Cat::paintGL(const GameData &gameData) {
+void Cat::paintGL(const GameData &gameData, const CatState &cat,
+                  float alpha, RenderQueue &queue) {
   if (gameData.m_state != State::Playing) return;
 
-  abcg::glUseProgram(m_program);
-
-  abcg::glBindVertexArray(m_vao);
-
-  abcg::glUniform1f(m_scaleLoc, m_scale);
-  abcg::glUniform1f(m_rotationLoc, m_rotation);
-  abcg::glUniform2fv(m_translationLoc, 1, &m_translation.x);
-
-  abcg::glUniform4fv(m_colorLoc, 1, &m_color.r);
-  abcg::glDrawElements(GL_TRIANGLES, 14 * 3, GL_UNSIGNED_INT, nullptr);
-
-  abcg::glBindVertexArray(0);
-
-  abcg::glUseProgram(0);
+  // Interpola entre os dois ultimos passos da simulacao
+  const auto rotation{
+      interpolateAngle(cat.m_previousRotation, cat.m_rotation, alpha)};
+  const auto translation{cat.interpolatedTranslation(alpha)};
+
+  auto &packet{queue.submit(RenderQueue::Layer::Cat, m_program, m_vao)};
+  packet.m_count = 14 * 3;
+  packet.m_indexed = true;
+  queue.uniform(m_scaleLoc, cat.m_scale);
+  queue.uniform(m_rotationLoc, rotation);
+  queue.uniform(m_translationLoc, translation);
+  queue.uniform(m_colorLoc, m_color);
 }
 
 void Cat::terminateGL() {
-  abcg::glDeleteBuffers(1, &m_vbo);
-  abcg::glDeleteBuffers(1, &m_ebo);
-  abcg::glDeleteVertexArrays(1, &m_vao);
-}
-
-void Cat::update(const GameData &gameData, float deltatime) {
-  // Move
-  if (gameData.m_input[static_cast<size_t>(Input::Left)] &&
-      m_translation.x > -(1 - m_scale))
-    m_translation += (glm::vec2{-0.7f, 0.0f}) * deltatime;
-  if (gameData.m_input[static_cast<size_t>(Input::Right)] &&
-      m_translation.x < (1 - m_scale))
-    m_translation += (glm::vec2{0.7f, 0.0f}) * deltatime;
-  if (gameData.m_input[static_cast<size_t>(Input::Up)] &&
-      m_translation.y < (1 - m_scale))
-    m_translation += (glm::vec2{0.0f, 0.7f}) * deltatime;
-  if (gameData.m_input[static_cast<size_t>(Input::Down)] &&
-      m_translation.y > -(1 - m_scale))
-    m_translation += (glm::vec2{0.0f, -0.7f}) * deltatime;
+  m_vbo.reset();
+  m_ebo.reset();
+  m_vao.reset();
 }
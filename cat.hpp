@@ -3,6 +3,9 @@
 
 #include "abcg.hpp"
 #include "gamedata.hpp"
+#include "glresource.hpp"
+#include "renderqueue.hpp"
+#include "simulation.hpp"
 
 class Asteroids;
 class Bullets;
@@ -12,12 +15,10 @@ class StarLayers;
 class Cat {
  public:
   void initializeGL(GLuint program);
-  void paintGL(const GameData &gameData);
+  void paintGL(const GameData &gameData, const CatState &cat, float alpha,
+               RenderQueue &queue);
   void terminateGL();
 
-  void update(const GameData &gameData, float deltaTime);
-  void setRotation(float rotation) { m_rotation = rotation; }
-
  private:
   friend Asteroids;
   friend OpenGLWindow;
@@ -29,15 +30,11 @@ class Cat {
   GLint m_scaleLoc{};
   GLint m_rotationLoc{};
 
-  GLuint m_vao{};
-  GLuint m_vbo{};
-  GLuint m_ebo{};
+  GLVertexArray m_vao;
+  GLBuffer m_vbo;
+  GLBuffer m_ebo;
 
   glm::vec4 m_color{glm:: vec4 {1.00f, 0.69f, 0.30f, 1.0f}};
-  float m_rotation{};
-  float m_scale{0.125f};
-  glm::vec2 m_translation{glm::vec2(0)};
-  glm::vec2 m_velocity{glm::vec2(0)};
 };
 
 #endif
\ No newline at end of file
@@ -1,99 +1,112 @@
 #include "clouds.hpp"
 
 #include <cppitertools/itertools.hpp>
+#include <cstddef>
 
-void Clouds::initializeGL(GLuint program, int quantity) {
+void Clouds::initializeGL(GLuint program, int quantity,
+                          std::pmr::memory_resource &scratch) {
   terminateGL();
 
   m_program = program;
   m_colorLoc = abcg::glGetUniformLocation(m_program, "color");
-  m_scaleLoc = abcg::glGetUniformLocation(m_program, "scale");
-  m_translationLoc = abcg::glGetUniformLocation(m_program, "translation");
 
-  // Cria nuvens
-  m_clouds.clear();
-  m_clouds.resize(quantity);
+  // Gera um quad por nuvem (ja posicionado) em uma so malha
+  std::pmr::vector<Vertex> vertices{&scratch};
+  std::pmr::vector<GLuint> indices{&scratch};
+  vertices.reserve(static_cast<std::size_t>(quantity) * 4);
+  indices.reserve(static_cast<std::size_t>(quantity) * 6);
+
   float dist = 0;
   float dist_c_to_e = 2 * m_radius * m_scale + 0.05;
   float dist_side = 0.05f;
-  for (auto &cloud : m_clouds) {
-    cloud = generateCloud(glm::vec2{-1 + dist_c_to_e + dist_side + dist,
-                                    1 - (m_radius * m_scale + 0.01)});
+  for ([[maybe_unused]] auto i : iter::range(quantity)) {
+    generateCloud(glm::vec2{-1 + dist_c_to_e + dist_side + dist,
+                            1 - (m_radius * m_scale + 0.01)},
+                  vertices, indices);
     dist += 2 * (1 - (dist_c_to_e + dist_side)) / (quantity - 1);
   }
-}
-
-void Clouds::paintGL() {
-  abcg::glUseProgram(m_program);
-
-  for (const auto &cloud : m_clouds) {
-    float dist = m_radius * m_scale + 0.05f;
-    for (const int mod : {-1, 0, 1}) {
-      abcg::glBindVertexArray(cloud.m_vao);
-
-      abcg::glUniform4fv(m_colorLoc, 1, &cloud.m_color.r);
-      abcg::glUniform1f(m_scaleLoc, m_scale);
-
-      abcg::glUniform2f(m_translationLoc, cloud.m_translation.x + mod * dist,
-                        cloud.m_translation.y);
-
-      abcg::glDrawArrays(GL_TRIANGLE_FAN, 0, cloud.m_polygonSides + 2);
-
-      abcg::glBindVertexArray(0);
-    }
-  }
-
-  abcg::glUseProgram(0);
-}
-
-void Clouds::terminateGL() {
-  for (auto cloud : m_clouds) {
-    abcg::glDeleteBuffers(1, &cloud.m_vbo);
-    abcg::glDeleteVertexArrays(1, &cloud.m_vao);
-  }
-}
-
-// Função para gerar nuvens de acordo com posição dada (posição do circulo
-// central)
-Clouds::Cloud Clouds::generateCloud(glm::vec2 translation) {
-  Cloud cloud;
-  cloud.m_translation = translation;
-  cloud.m_color = m_cloud_color;
-
-  // Criar geometria
-  std::vector<glm::vec2> positions(0);
-  positions.emplace_back(0, 0);
-  const auto step{M_PI * 2 / cloud.m_polygonSides};
-  for (const auto angle : iter::range(0.0, M_PI * 2, step)) {
-    positions.emplace_back(m_radius * std::cos(angle),
-                           m_radius * std::sin(angle));
-  }
-  positions.push_back(positions.at(1));
+  m_indexCount = static_cast<GLsizei>(indices.size());
 
   // Gerar VBO
-  abcg::glGenBuffers(1, &cloud.m_vbo);
-  abcg::glBindBuffer(GL_ARRAY_BUFFER, cloud.m_vbo);
-  abcg::glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec2),
-                     positions.data(), GL_STATIC_DRAW);
+  m_vbo = GLBuffer{GLResourceRegistry::Owner::Clouds};
+  abcg::glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+  bufferData(m_vbo, GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex),
+             vertices.data(), GL_STATIC_DRAW);
   abcg::glBindBuffer(GL_ARRAY_BUFFER, 0);
 
+  // Gerar EBO
+  m_ebo = GLBuffer{GLResourceRegistry::Owner::Clouds};
+  abcg::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+  bufferData(m_ebo, GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint),
+             indices.data(), GL_STATIC_DRAW);
+  abcg::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
   // Pegar localizacao dos atributos no programa
   GLint positionAttribute{abcg::glGetAttribLocation(m_program, "inPosition")};
+  GLint centerAttribute{abcg::glGetAttribLocation(m_program, "inCenter")};
+  GLint shapeAttribute{abcg::glGetAttribLocation(m_program, "inShape")};
 
   // Criar VAO
-  abcg::glGenVertexArrays(1, &cloud.m_vao);
+  m_vao = GLVertexArray{GLResourceRegistry::Owner::Clouds};
 
   // Vincular atributos de vértice ao VAO atual
-  abcg::glBindVertexArray(cloud.m_vao);
+  abcg::glBindVertexArray(m_vao);
 
-  abcg::glBindBuffer(GL_ARRAY_BUFFER, cloud.m_vbo);
+  abcg::glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
   abcg::glEnableVertexAttribArray(positionAttribute);
-  abcg::glVertexAttribPointer(positionAttribute, 2, GL_FLOAT, GL_FALSE, 0,
-                              nullptr);
+  abcg::glVertexAttribPointer(
+      positionAttribute, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+      reinterpret_cast<void *>(offsetof(Vertex, m_position)));
+  abcg::glEnableVertexAttribArray(centerAttribute);
+  abcg::glVertexAttribPointer(
+      centerAttribute, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+      reinterpret_cast<void *>(offsetof(Vertex, m_center)));
+  abcg::glEnableVertexAttribArray(shapeAttribute);
+  abcg::glVertexAttribPointer(
+      shapeAttribute, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
+      reinterpret_cast<void *>(offsetof(Vertex, m_shape)));
   abcg::glBindBuffer(GL_ARRAY_BUFFER, 0);
 
+  abcg::glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+
   //  Fim da ligação ao VAO atual
   abcg::glBindVertexArray(0);
+}
+
+void Clouds::paintGL(RenderQueue &queue) {
+  // A cobertura da borda vem no alfa: mistura com o fundo
+  auto &packet{queue.submit(RenderQueue::Layer::Clouds, m_program, m_vao,
+                            BlendMode::Alpha)};
+  packet.m_count = m_indexCount;
+  packet.m_indexed = true;
+  queue.uniform(m_colorLoc, m_cloud_color);
+}
 
-  return cloud;
-}
\ No newline at end of file
+void Clouds::terminateGL() {
+  m_vbo.reset();
+  m_ebo.reset();
+  m_vao.reset();
+}
+
+// Função para gerar nuvens de acordo com posição dada (posição do circulo
+// central). A nuvem tem tres circulos lado a lado; o quad cobre os tres mais
+// a margem, e o fragment shader recorta a forma
+void Clouds::generateCloud(glm::vec2 translation,
+                           std::pmr::vector<Vertex> &vertices,
+                           std::pmr::vector<GLuint> &indices) const {
+  const auto radius{m_radius * m_scale};
+  const float dist = m_radius * m_scale + 0.05f;
+  const glm::vec2 shape{radius, dist};
+  const glm::vec2 extent{dist + radius + m_padding, radius + m_padding};
+  const auto first{static_cast<GLuint>(vertices.size())};
+
+  for (const auto &corner : {glm::vec2{-1, -1}, glm::vec2{+1, -1},
+                             glm::vec2{+1, +1}, glm::vec2{-1, +1}}) {
+    vertices.push_back(Vertex{translation + corner * extent, translation,
+                              shape});
+  }
+
+  for (const GLuint index : {0u, 1u, 2u, 0u, 2u, 3u}) {
+    indices.push_back(first + index);
+  }
+}
@@ -1,18 +1,27 @@
 #ifndef CLOUDS_HPP_
 #define CLOUDS_HPP_
 
-#include <list>
+#include <memory_resource>
+#include <vector>
 
 #include "abcg.hpp"
 #include "cat.hpp"
 #include "gamedata.hpp"
+#include "glresource.hpp"
+#include "renderqueue.hpp"
 
 class OpenGLWindow;
 
+// Camada de nuvens estatica: cada nuvem e um unico quad, e o shader sdf.frag
+// desenha a uniao dos tres circulos pela distancia com sinal, com bordas
+// suavizadas analiticamente. Todos os quads ficam em uma malha indexada,
+// desenhada com um so draw call
 class Clouds {
  public:
-  void initializeGL(GLuint program, int quantity);
-  void paintGL();
+  // A malha e montada em scratch e enviada ao VBO; nada dela fica na CPU
+  void initializeGL(GLuint program, int quantity,
+                    std::pmr::memory_resource &scratch);
+  void paintGL(RenderQueue &queue);
   void terminateGL();
 
  private:
@@ -20,24 +29,27 @@ class Clouds {
 
   GLuint m_program{};
   GLint m_colorLoc{};
-  GLint m_translationLoc{};
-  GLint m_scaleLoc{};
   float m_radius{0.5f};
   float m_scale{0.25};
+  // Margem do quad alem da borda, para o antialiasing
+  float m_padding{0.01f};
   glm::vec4 m_cloud_color{1};
-  struct Cloud {
-    GLuint m_vao{};
-    GLuint m_vbo{};
 
-    glm::vec4 m_color{1};
-    int m_polygonSides{50};
+  GLVertexArray m_vao;
+  GLBuffer m_vbo;
+  GLBuffer m_ebo;
+  GLsizei m_indexCount{};
 
-    glm::vec2 m_translation{glm::vec2(0)};
+  // Layout do VBO (sdf.vert): posicao, centro e (raio, espacamento)
+  struct Vertex {
+    glm::vec2 m_position;
+    glm::vec2 m_center;
+    glm::vec2 m_shape;
   };
 
-  std::list<Cloud> m_clouds;
-
-  Clouds::Cloud generateCloud(glm::vec2 translation);
+  void generateCloud(glm::vec2 translation,
+                     std::pmr::vector<Vertex> &vertices,
+                     std::pmr::vector<GLuint> &indices) const;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,74 @@
+#ifndef CONCURRENCY_HPP_
+#define CONCURRENCY_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Buffer triplo sem travas para um produtor e um consumidor. O produtor
+// escreve em back() e chama publish(); o consumidor chama update() e le
+// front(). Nenhum dos dois espera pelo outro: o produtor sempre tem um
+// buffer livre e o consumidor sempre tem a copia publicada mais recente
+template <typename T>
+class TripleBuffer {
+ public:
+  T &back() { return m_buffers[m_back]; }
+  [[nodiscard]] const T &front() const { return m_buffers[m_front]; }
+
+  void publish() {
+    const auto previous{m_middle.exchange(m_back | m_dirty)};
+    m_back = previous & m_indexMask;
+  }
+
+  // Troca front() pela copia publicada, se houver uma nova
+  bool update() {
+    if ((m_middle.load(std::memory_order_acquire) & m_dirty) == 0) {
+      return false;
+    }
+    const auto previous{m_middle.exchange(m_front)};
+    m_front = previous & m_indexMask;
+    return true;
+  }
+
+ private:
+  static constexpr std::uint8_t m_indexMask{0x3};
+  static constexpr std::uint8_t m_dirty{0x4};
+
+  std::array<T, 3> m_buffers{};
+  std::atomic<std::uint8_t> m_middle{1};
+  std::uint8_t m_back{0};
+  std::uint8_t m_front{2};
+};
+
+// Fila circular sem travas para um produtor e um consumidor. push() falha se
+// a fila estiver cheia
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+ public:
+  bool push(const T &value) {
+    const auto tail{m_tail.load(std::memory_order_relaxed)};
+    const auto next{(tail + 1) % Capacity};
+    if (next == m_head.load(std::memory_order_acquire)) return false;
+
+    m_values[tail] = value;
+    m_tail.store(next, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(T &value) {
+    const auto head{m_head.load(std::memory_order_relaxed)};
+    if (head == m_tail.load(std::memory_order_acquire)) return false;
+
+    value = m_values[head];
+    m_head.store((head + 1) % Capacity, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  std::array<T, Capacity> m_values{};
+  alignas(64) std::atomic<std::size_t> m_head{0};
+  alignas(64) std::atomic<std::size_t> m_tail{0};
+};
+
+#endif
@@ -0,0 +1,33 @@
+#include "framearena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+FrameArena::FrameArena(std::size_t capacity) : m_buffer(capacity) {}
+
+void FrameArena::reset() {
+  m_peak = std::max(m_peak, used());
+
+  // Cresce para caber o maior quadro visto ate agora
+  if (m_overflow > 0) {
+    m_overflowResource.release();
+    m_buffer.resize(std::max(m_buffer.size() * 2, m_peak));
+  }
+
+  m_offset = 0;
+  m_overflow = 0;
+}
+
+void *FrameArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+  const auto base{reinterpret_cast<std::uintptr_t>(m_buffer.data())};
+  const auto aligned{(base + m_offset + alignment - 1) & ~(alignment - 1)};
+  const auto end{aligned - base + bytes};
+
+  if (end <= m_buffer.size()) {
+    m_offset = end;
+    return reinterpret_cast<void *>(aligned);
+  }
+
+  m_overflow += bytes + alignment;
+  return m_overflowResource.allocate(bytes, alignment);
+}
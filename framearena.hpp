@@ -0,0 +1,40 @@
+#ifndef FRAMEARENA_HPP_
+#define FRAMEARENA_HPP_
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+// Alocador linear (bump) para dados que so vivem durante um quadro. Pode ser
+// usado por qualquer container std::pmr; deallocate() nao faz nada e reset()
+// libera tudo de uma vez no inicio do quadro seguinte. Se um quadro precisar
+// de mais memoria que o bloco atual, o excedente vem do heap e o bloco cresce
+// no proximo reset(), entao em regime permanente nenhum quadro aloca no heap
+class FrameArena : public std::pmr::memory_resource {
+ public:
+  explicit FrameArena(std::size_t capacity = 64 * 1024);
+
+  void reset();
+
+  [[nodiscard]] std::size_t used() const { return m_offset + m_overflow; }
+  [[nodiscard]] std::size_t capacity() const { return m_buffer.size(); }
+  [[nodiscard]] std::size_t peak() const { return m_peak; }
+
+ private:
+  std::vector<std::byte> m_buffer;
+  std::size_t m_offset{};
+
+  // Memoria extra do quadro atual, liberada no reset()
+  std::pmr::monotonic_buffer_resource m_overflowResource;
+  std::size_t m_overflow{};
+  std::size_t m_peak{};
+
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void *, std::size_t, std::size_t) override {}
+  [[nodiscard]] bool do_is_equal(
+      const std::pmr::memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+};
+
+#endif
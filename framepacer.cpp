@@ -0,0 +1,109 @@
+#include "framepacer.hpp"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#include "abcg.hpp"
+
+void FramePacer::History::push(float value) {
+  m_values[m_next] = value;
+  m_next = (m_next + 1) % m_values.size();
+  m_size = std::min(m_size + 1, m_values.size());
+}
+
+float FramePacer::History::average() const {
+  if (m_size == 0) return 0.0f;
+  float sum{0.0f};
+  for (std::size_t i{0}; i < m_size; ++i) {
+    sum += m_values[i];
+  }
+  return sum / static_cast<float>(m_size);
+}
+
+// Desvio padrao: o jitter do intervalo entre quadros
+float FramePacer::History::deviation() const {
+  if (m_size < 2) return 0.0f;
+  const auto mean{average()};
+  float sum{0.0f};
+  for (std::size_t i{0}; i < m_size; ++i) {
+    sum += (m_values[i] - mean) * (m_values[i] - mean);
+  }
+  return std::sqrt(sum / static_cast<float>(m_size - 1));
+}
+
+float FramePacer::History::maximum() const {
+  if (m_size == 0) return 0.0f;
+  return *std::max_element(m_values.begin(),
+                           m_values.begin() +
+                               static_cast<std::ptrdiff_t>(m_size));
+}
+
+void FramePacer::beginFrame() {
+  if (m_targetFps > 0) wait();
+
+  const auto now{Clock::now()};
+  if (m_lastFrame != Clock::time_point{}) {
+    m_frameIntervals.push(
+        std::chrono::duration<float, std::milli>{now - m_lastFrame}.count());
+  }
+  m_lastFrame = now;
+}
+
+void FramePacer::wait() {
+  const auto period{std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>{1.0 / m_targetFps})};
+
+  // Mantem os prazos alinhados; apos um atraso maior que um quadro (ou ao
+  // ligar o limite) recomeca a partir de agora
+  auto now{Clock::now()};
+  m_deadline += period;
+  if (m_deadline < now - period || m_deadline > now + period) {
+    m_deadline = now;
+    return;
+  }
+
+  if (m_deadline - now > m_spinMargin) {
+    std::this_thread::sleep_until(m_deadline - m_spinMargin);
+  }
+  while (Clock::now() < m_deadline) {
+    std::this_thread::yield();
+  }
+}
+
+void FramePacer::inputReceived(Clock::time_point time) {
+  if (!m_pendingInput) m_pendingInput = time;
+}
+
+void FramePacer::inputSubmitted() {
+  if (!m_pendingInput) return;
+  m_latencies.push(std::chrono::duration<float, std::milli>{
+      Clock::now() - *m_pendingInput}.count());
+  m_pendingInput.reset();
+}
+
+void FramePacer::paintUI() {
+  if (!m_visible) return;
+
+  ImGui::SetNextWindowPos(ImVec2(340, 150), ImGuiCond_FirstUseEver);
+  ImGui::SetNextWindowSize(ImVec2(255, 220), ImGuiCond_FirstUseEver);
+  ImGui::Begin("Frame pacing (F7)", &m_visible);
+
+  ImGui::SliderInt("FPS alvo", &m_targetFps, 0, 240,
+                   m_targetFps == 0 ? "sem limite" : "%d");
+  if (ImGui::Checkbox("VSync", &m_vsync)) {
+    SDL_GL_SetSwapInterval(m_vsync ? 1 : 0);
+  }
+  ImGui::Checkbox("Baixa latencia", &m_lowLatency);
+  ImGui::Separator();
+
+  ImGui::Text("Quadro: %.2f ms (max %.2f)", m_frameIntervals.average(),
+              m_frameIntervals.maximum());
+  ImGui::Text("Jitter: %.3f ms", m_frameIntervals.deviation());
+  ImGui::Text("Latencia entrada: %.2f ms (max %.2f)", m_latencies.average(),
+              m_latencies.maximum());
+
+  ImGui::End();
+}
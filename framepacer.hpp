@@ -0,0 +1,59 @@
+#ifndef FRAMEPACER_HPP_
+#define FRAMEPACER_HPP_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+
+// Ritmo dos quadros: limita a taxa a m_targetFps (0 = sem limite) dormindo
+// ate pouco antes do prazo e terminando a espera em spin, e mede o intervalo
+// entre quadros (media e desvio padrao) e a latencia entre a chegada de uma
+// entrada e o envio do desenho do gato. Com m_lowLatency, a janela amostra o
+// mouse e o teclado logo antes de desenhar o gato (ver OpenGLWindow)
+class FramePacer {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  // Espera o prazo do quadro (se houver limite) e registra o intervalo
+  void beginFrame();
+
+  // Uma entrada chegou; a latencia e medida ate o proximo inputSubmitted()
+  void inputReceived(Clock::time_point time = Clock::now());
+  void inputSubmitted();
+
+  void paintUI();
+
+  bool m_visible{false};
+  bool m_lowLatency{false};
+  int m_targetFps{0};
+
+ private:
+  static constexpr std::size_t m_historySize{240};
+  // Parte final da espera feita em spin: sleep_until acorda com atraso de
+  // ate alguns milissegundos dependendo do escalonador
+  static constexpr std::chrono::microseconds m_spinMargin{1500};
+
+  struct History {
+    std::array<float, m_historySize> m_values{};
+    std::size_t m_next{};
+    std::size_t m_size{};
+
+    void push(float value);
+    [[nodiscard]] float average() const;
+    [[nodiscard]] float deviation() const;
+    [[nodiscard]] float maximum() const;
+  };
+
+  History m_frameIntervals;
+  History m_latencies;
+
+  Clock::time_point m_deadline;
+  Clock::time_point m_lastFrame;
+  std::optional<Clock::time_point> m_pendingInput;
+  bool m_vsync{true};
+
+  void wait();
+};
+
+#endif
@@ -0,0 +1,98 @@
+#include "glresource.hpp"
+
+#include <fmt/core.h>
+#include <imgui.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+constexpr std::array ownerNames{"Programas", "Estrelas", "Nuvens",
+                                "Asteroides", "Gato",     "Streaming",
+                                "Alvos"};
+constexpr std::array kindNames{"buffers", "VAOs", "renderbuffers",
+                               "framebuffers", "programas"};
+}  // namespace
+
+std::array<GLResourceRegistry::Usage, GLResourceRegistry::m_ownerCount>
+    GLResourceRegistry::m_usage{};
+
+long GLResourceRegistry::Usage::objects() const {
+  return std::accumulate(m_objects.begin(), m_objects.end(), 0L);
+}
+
+long GLResourceRegistry::liveObjects() {
+  long total{0};
+  for (const auto &entry : m_usage) total += entry.objects();
+  return total;
+}
+
+std::size_t GLResourceRegistry::liveBytes() {
+  std::size_t total{0};
+  for (const auto &entry : m_usage) total += entry.m_bytes;
+  return total;
+}
+
+void GLResourceRegistry::paintUI() {
+  ImGui::Columns(4);
+  ImGui::Text("Modulo");
+  ImGui::NextColumn();
+  ImGui::Text("Objetos");
+  ImGui::NextColumn();
+  ImGui::Text("KiB");
+  ImGui::NextColumn();
+  ImGui::Text("Enviados (KiB)");
+  ImGui::NextColumn();
+  ImGui::Separator();
+  for (std::size_t index{0}; index < m_ownerCount; ++index) {
+    const auto &entry{m_usage[index]};
+    ImGui::Text("%s", ownerNames.at(index));
+    ImGui::NextColumn();
+    ImGui::Text("%ld", entry.objects());
+    ImGui::NextColumn();
+    ImGui::Text("%.1f", static_cast<double>(entry.m_bytes) / 1024.0);
+    ImGui::NextColumn();
+    ImGui::Text("%.0f", static_cast<double>(entry.m_uploaded) / 1024.0);
+    ImGui::NextColumn();
+  }
+  ImGui::Columns(1);
+  ImGui::Text("Total: %ld objetos, %.1f KiB", liveObjects(),
+              static_cast<double>(liveBytes()) / 1024.0);
+}
+
+long GLResourceRegistry::reportLeaks() {
+  for (std::size_t owner{0}; owner < m_ownerCount; ++owner) {
+    const auto &entry{m_usage[owner]};
+    for (std::size_t kind{0}; kind < m_kindCount; ++kind) {
+      if (entry.m_objects[kind] == 0) continue;
+      fmt::print(stderr, "GL leak: {} {} ({})\n", entry.m_objects[kind],
+                 kindNames.at(kind), ownerNames.at(owner));
+    }
+  }
+  return liveObjects();
+}
+
+void bufferData(GLBuffer &buffer, GLenum target, GLsizeiptr size,
+                const void *data, GLenum usage) {
+  abcg::glBufferData(target, size, data, usage);
+  buffer.setStorage(static_cast<std::size_t>(size));
+  if (data != nullptr) buffer.uploaded(static_cast<std::size_t>(size));
+}
+
+void bufferSubData(const GLBuffer &buffer, GLenum target, GLintptr offset,
+                   GLsizeiptr size, const void *data) {
+  abcg::glBufferSubData(target, offset, size, data);
+  buffer.uploaded(static_cast<std::size_t>(size));
+}
+
+void renderbufferStorage(GLRenderbuffer &renderbuffer, GLsizei samples,
+                         GLsizei width, GLsizei height) {
+  if (samples > 0) {
+    abcg::glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_RGBA8,
+                                           width, height);
+  } else {
+    abcg::glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+  }
+  renderbuffer.setStorage(static_cast<std::size_t>(width) * height * 4 *
+                          std::max(samples, 1));
+}
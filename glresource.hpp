@@ -0,0 +1,207 @@
+#ifndef GLRESOURCE_HPP_
+#define GLRESOURCE_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "abcg.hpp"
+
+// Contabilidade dos objetos OpenGL vivos, por modulo dono: numero de objetos
+// de cada tipo, bytes de armazenamento alocados e bytes enviados a GPU desde
+// o inicio. Atualizada pelos GLHandle (todo o acesso ao GL e feito na thread
+// de renderizacao). O perfilador mostra a tabela e o terminateGL da janela
+// confere que nada ficou vivo
+class GLResourceRegistry {
+ public:
+  enum class Owner {
+    Programs,
+    Stars,
+    Clouds,
+    Asteroids,
+    Cat,
+    Stream,
+    Targets,
+    Count
+  };
+  enum class Kind {
+    Buffer,
+    VertexArray,
+    Renderbuffer,
+    Framebuffer,
+    Program,
+    Count
+  };
+
+  static void created(Owner owner, Kind kind) { ++usage(owner).at(kind); }
+  static void destroyed(Owner owner, Kind kind) { --usage(owner).at(kind); }
+  // Troca o tamanho registrado do armazenamento de um objeto
+  static void resized(Owner owner, std::size_t oldBytes,
+                      std::size_t newBytes) {
+    auto &entry{usage(owner)};
+    entry.m_bytes = entry.m_bytes - oldBytes + newBytes;
+  }
+  static void uploaded(Owner owner, std::size_t bytes) {
+    usage(owner).m_uploaded += bytes;
+  }
+
+  [[nodiscard]] static long liveObjects();
+  [[nodiscard]] static std::size_t liveBytes();
+
+  // Tabela por modulo (dentro de uma janela do ImGui ja aberta)
+  static void paintUI();
+  // Escreve em stderr os objetos ainda vivos; retorna quantos sao
+  static long reportLeaks();
+
+ private:
+  static constexpr std::size_t m_ownerCount{
+      static_cast<std::size_t>(Owner::Count)};
+  static constexpr std::size_t m_kindCount{
+      static_cast<std::size_t>(Kind::Count)};
+
+  struct Usage {
+    std::array<long, m_kindCount> m_objects{};
+    std::size_t m_bytes{};
+    std::uint64_t m_uploaded{};
+
+    long &at(Kind kind) { return m_objects[static_cast<std::size_t>(kind)]; }
+    [[nodiscard]] long objects() const;
+  };
+
+  static std::array<Usage, m_ownerCount> m_usage;
+
+  static Usage &usage(Owner owner) {
+    return m_usage[static_cast<std::size_t>(owner)];
+  }
+};
+
+// Como criar e destruir cada tipo de objeto
+struct GLBufferTraits {
+  static constexpr auto m_kind{GLResourceRegistry::Kind::Buffer};
+  static GLuint create() {
+    GLuint name{};
+    abcg::glGenBuffers(1, &name);
+    return name;
+  }
+  static void destroy(GLuint name) { abcg::glDeleteBuffers(1, &name); }
+};
+
+struct GLVertexArrayTraits {
+  static constexpr auto m_kind{GLResourceRegistry::Kind::VertexArray};
+  static GLuint create() {
+    GLuint name{};
+    abcg::glGenVertexArrays(1, &name);
+    return name;
+  }
+  static void destroy(GLuint name) { abcg::glDeleteVertexArrays(1, &name); }
+};
+
+struct GLRenderbufferTraits {
+  static constexpr auto m_kind{GLResourceRegistry::Kind::Renderbuffer};
+  static GLuint create() {
+    GLuint name{};
+    abcg::glGenRenderbuffers(1, &name);
+    return name;
+  }
+  static void destroy(GLuint name) { abcg::glDeleteRenderbuffers(1, &name); }
+};
+
+struct GLFramebufferTraits {
+  static constexpr auto m_kind{GLResourceRegistry::Kind::Framebuffer};
+  static GLuint create() {
+    GLuint name{};
+    abcg::glGenFramebuffers(1, &name);
+    return name;
+  }
+  static void destroy(GLuint name) { abcg::glDeleteFramebuffers(1, &name); }
+};
+
+struct GLProgramTraits {
+  static constexpr auto m_kind{GLResourceRegistry::Kind::Program};
+  static GLuint create() { return abcg::glCreateProgram(); }
+  static void destroy(GLuint name) { abcg::glDeleteProgram(name); }
+};
+
+// Dono unico (so movel) de um objeto OpenGL. Substituir o handle libera o
+// objeto anterior, entao reinicializar um modulo nao vaza. O destrutor tambem
+// libera, mas os terminateGL devem chamar reset() enquanto o contexto existe:
+// os membros da janela so sao destruidos depois do contexto
+template <typename Traits>
+class GLHandle {
+ public:
+  using Owner = GLResourceRegistry::Owner;
+
+  GLHandle() = default;
+  // Cria um objeto novo
+  explicit GLHandle(Owner owner) : GLHandle{owner, Traits::create()} {}
+  // Assume a posse de um objeto ja criado (ex.: programa do ProgramCache)
+  GLHandle(Owner owner, GLuint name) : m_name{name}, m_owner{owner} {
+    if (m_name != 0) GLResourceRegistry::created(m_owner, Traits::m_kind);
+  }
+  ~GLHandle() { reset(); }
+
+  GLHandle(const GLHandle &) = delete;
+  GLHandle &operator=(const GLHandle &) = delete;
+
+  GLHandle(GLHandle &&other) noexcept
+      : m_name{std::exchange(other.m_name, 0)},
+        m_owner{other.m_owner},
+        m_bytes{std::exchange(other.m_bytes, 0)} {}
+  GLHandle &operator=(GLHandle &&other) noexcept {
+    if (this != &other) {
+      reset();
+      m_name = std::exchange(other.m_name, 0);
+      m_owner = other.m_owner;
+      m_bytes = std::exchange(other.m_bytes, 0);
+    }
+    return *this;
+  }
+
+  void reset() {
+    if (m_name == 0) return;
+    GLResourceRegistry::resized(m_owner, m_bytes, 0);
+    GLResourceRegistry::destroyed(m_owner, Traits::m_kind);
+    Traits::destroy(m_name);
+    m_name = 0;
+    m_bytes = 0;
+  }
+
+  // Registra o tamanho do armazenamento atual do objeto
+  void setStorage(std::size_t bytes) {
+    GLResourceRegistry::resized(m_owner, m_bytes, bytes);
+    m_bytes = bytes;
+  }
+  void uploaded(std::size_t bytes) const {
+    GLResourceRegistry::uploaded(m_owner, bytes);
+  }
+
+  [[nodiscard]] GLuint get() const { return m_name; }
+  // O handle e usado direto nas chamadas GL (glBindBuffer(target, m_vbo))
+  operator GLuint() const { return m_name; }
+
+ private:
+  GLuint m_name{};
+  Owner m_owner{};
+  std::size_t m_bytes{};
+};
+
+using GLBuffer = GLHandle<GLBufferTraits>;
+using GLVertexArray = GLHandle<GLVertexArrayTraits>;
+using GLRenderbuffer = GLHandle<GLRenderbufferTraits>;
+using GLFramebuffer = GLHandle<GLFramebufferTraits>;
+using GLProgram = GLHandle<GLProgramTraits>;
+
+// glBufferData no buffer vinculado a target, registrando o armazenamento (e
+// o envio, se houver dados)
+void bufferData(GLBuffer &buffer, GLenum target, GLsizeiptr size,
+                const void *data, GLenum usage);
+// glBufferSubData no buffer vinculado a target, registrando o envio
+void bufferSubData(const GLBuffer &buffer, GLenum target, GLintptr offset,
+                   GLsizeiptr size, const void *data);
+// glRenderbufferStorage(Multisample) RGBA8 no renderbuffer vinculado; o
+// tamanho registrado conta 4 bytes por pixel e por amostra
+void renderbufferStorage(GLRenderbuffer &renderbuffer, GLsizei samples,
+                         GLsizei width, GLsizei height);
+
+#endif
@@ -0,0 +1,98 @@
+#include "glstatecache.hpp"
+
+#include <algorithm>
+
+#include "profiler.hpp"
+
+void GLStateCache::invalidate() {
+  m_program = m_unknown;
+  m_vao = m_unknown;
+  m_arrayBuffer = m_unknown;
+  m_blendKnown = false;
+}
+
+void GLStateCache::clear() {
+  invalidate();
+  m_uniforms.clear();
+}
+
+void GLStateCache::useProgram(GLuint program) {
+  const auto changed{program != m_program};
+  FrameProfiler::countStateCall(changed);
+  if (!changed) return;
+
+  m_program = program;
+  abcg::glUseProgram(program);
+}
+
+void GLStateCache::bindVertexArray(GLuint vao) {
+  const auto changed{vao != m_vao};
+  FrameProfiler::countStateCall(changed);
+  if (!changed) return;
+
+  m_vao = vao;
+  abcg::glBindVertexArray(vao);
+}
+
+void GLStateCache::bindArrayBuffer(GLuint buffer) {
+  const auto changed{buffer != m_arrayBuffer};
+  FrameProfiler::countStateCall(changed);
+  if (!changed) return;
+
+  m_arrayBuffer = buffer;
+  abcg::glBindBuffer(GL_ARRAY_BUFFER, buffer);
+}
+
+void GLStateCache::setBlend(BlendMode blend) {
+  const auto changed{!m_blendKnown || blend != m_blend};
+  FrameProfiler::countStateCall(changed);
+  if (!changed) return;
+
+  // glEnable/glDisable so quando o blend liga ou desliga de fato
+  const auto wasEnabled{m_blendKnown && m_blend != BlendMode::Opaque};
+  const auto enabled{blend != BlendMode::Opaque};
+  if (!m_blendKnown || wasEnabled != enabled) {
+    if (enabled) {
+      abcg::glEnable(GL_BLEND);
+    } else {
+      abcg::glDisable(GL_BLEND);
+    }
+  }
+
+  if (blend == BlendMode::Additive) {
+    abcg::glBlendFunc(GL_ONE, GL_ONE);
+  } else if (blend == BlendMode::Alpha) {
+    abcg::glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  }
+
+  m_blend = blend;
+  m_blendKnown = true;
+}
+
+void GLStateCache::uniform(GLint location, GLint components,
+                           const float *values) {
+  if (location < 0) return;
+
+  const auto key{static_cast<std::uint64_t>(m_program) << 32 |
+                 static_cast<std::uint32_t>(location)};
+  std::array<float, 4> value{};
+  std::copy(values, values + components, value.begin());
+
+  const auto [entry, inserted]{m_uniforms.try_emplace(key, value)};
+  const auto changed{inserted || entry->second != value};
+  FrameProfiler::countStateCall(changed);
+  if (!changed) return;
+
+  entry->second = value;
+  switch (components) {
+    case 1:
+      abcg::glUniform1fv(location, 1, values);
+      break;
+    case 2:
+      abcg::glUniform2fv(location, 1, values);
+      break;
+    default:
+      abcg::glUniform4fv(location, 1, values);
+      break;
+  }
+}
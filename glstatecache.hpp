@@ -0,0 +1,45 @@
+#ifndef GLSTATECACHE_HPP_
+#define GLSTATECACHE_HPP_
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+
+#include "abcg.hpp"
+
+enum class BlendMode : std::uint8_t { Opaque, Additive, Alpha };
+
+// Camada fina sobre abcg::gl* que lembra o estado atual e nao repete
+// chamadas que nao mudam nada: programa, VAO, buffer de vertices, blend e
+// valores de uniformes. Cada chamada e contada como emitida ou evitada no
+// FrameProfiler. Os uniformes ficam guardados no proprio programa, entao o
+// cache deles vale entre quadros; os binds podem ser alterados por codigo
+// fora do cache (ex.: ImGui, StreamBuffer) e sao esquecidos em invalidate()
+class GLStateCache {
+ public:
+  void invalidate();
+  // Esquece tambem os uniformes (ex.: programas recriados)
+  void clear();
+
+  void useProgram(GLuint program);
+  void bindVertexArray(GLuint vao);
+  void bindArrayBuffer(GLuint buffer);
+  void setBlend(BlendMode blend);
+
+  // Uniforme float de 1, 2 ou 4 componentes do programa atual
+  void uniform(GLint location, GLint components, const float *values);
+
+ private:
+  // Valores de uma chamada que ainda nao foi feita (ou esquecida)
+  static constexpr GLuint m_unknown{~GLuint{0}};
+
+  GLuint m_program{m_unknown};
+  GLuint m_vao{m_unknown};
+  GLuint m_arrayBuffer{m_unknown};
+  bool m_blendKnown{false};
+  BlendMode m_blend{BlendMode::Opaque};
+
+  std::unordered_map<std::uint64_t, std::array<float, 4>> m_uniforms;
+};
+
+#endif
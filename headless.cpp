@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "allocationcounter.hpp"
+#include "replay.hpp"
+#include "simulation.hpp"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>{Clock::now() - start}.count();
+}
+
+// Re-simula um replay e compara o checksum de cada passo
+int playReplay(const std::string &path) {
+  ReplayPlayer player;
+  if (!player.load(path)) {
+    std::fprintf(stderr, "invalid replay: %s\n", path.c_str());
+    return 1;
+  }
+
+  Simulation simulation;
+  const auto start{Clock::now()};
+  const auto result{player.play(simulation)};
+  const auto elapsed{secondsSince(start)};
+
+  std::printf("ticks: %zu\n", result.m_ticks);
+  std::printf("elapsed: %.3f s\n", elapsed);
+  std::printf("ticks/s: %.0f\n", static_cast<double>(result.m_ticks) / elapsed);
+  if (result.m_firstMismatch >= 0) {
+    std::printf("checksum mismatch at tick %ld\n", result.m_firstMismatch);
+    return 1;
+  }
+  std::printf("checksums: ok\n");
+  return 0;
+}
+}  // namespace
+
+// Executa a simulacao sem janela nem OpenGL, o mais rapido possivel.
+// Uso: catrun_headless [passos] [passos/s] [colisao entre asteroides 0/1]
+//      catrun_headless --record <arquivo> [passos] [passos/s] [colisao 0/1]
+//      catrun_headless --replay <arquivo>
+// A partida e reiniciada sempre que termina, para manter a carga de jogo
+int main(int argc, char **argv) {
+  const std::string mode{argc > 1 ? argv[1] : ""};
+  if (mode == "--replay" && argc > 2) {
+    return playReplay(argv[2]);
+  }
+
+  std::string recordPath;
+  auto arg{1};
+  if (mode == "--record" && argc > 2) {
+    recordPath = argv[2];
+    arg = 3;
+  }
+
+  const auto frames{argc > arg ? std::stol(argv[arg]) : 100000L};
+
+  Simulation simulation;
+  if (argc > arg + 1) simulation.setTickRate(std::stof(argv[arg + 1]));
+  simulation.m_asteroidCollisions =
+      argc > arg + 2 && std::stoi(argv[arg + 2]) != 0;
+  simulation.initialize(42);
+
+  ReplayRecorder recorder;
+  if (recordPath.empty()) {
+    simulation.restart();
+  } else {
+    recorder.begin(simulation, 7, 0);
+    recorder.reserve(static_cast<std::size_t>(frames));
+  }
+
+  int rounds{1};
+  std::size_t maxAsteroids{0};
+
+  // Alocacoes contadas so na segunda metade, depois do aquecimento. Nesse
+  // regime a simulacao nao pode alocar (falha com codigo 1)
+  std::uint64_t allocationsAtHalf{0};
+
+  const auto start{Clock::now()};
+  for (long frame{0}; frame < frames; ++frame) {
+    if (frame == frames / 2) allocationsAtHalf = AllocationCounter::count();
+    simulation.update(simulation.fixedDeltaTime());
+    maxAsteroids = std::max(maxAsteroids, simulation.m_asteroids.size());
+
+    if (simulation.m_gameData.m_state == State::GameOver ||
+        simulation.m_gameData.m_state == State::Win) {
+      simulation.requestRestart();
+      ++rounds;
+    }
+  }
+  const auto elapsed{secondsSince(start)};
+
+  std::printf("frames: %ld\n", frames);
+  std::printf("rounds: %d\n", rounds);
+  std::printf("max asteroids: %zu\n", maxAsteroids);
+  std::printf("elapsed: %.3f s\n", elapsed);
+  std::printf("frames/s: %.0f\n", static_cast<double>(frames) / elapsed);
+  const auto allocations{AllocationCounter::count() - allocationsAtHalf};
+  if (AllocationCounter::enabled()) {
+    std::printf("heap allocations (second half): %llu\n",
+                static_cast<unsigned long long>(allocations));
+  }
+
+  if (!recordPath.empty()) {
+    recorder.end(simulation);
+    if (!recorder.save(recordPath)) {
+      std::fprintf(stderr, "could not write %s\n", recordPath.c_str());
+      return 1;
+    }
+  }
+  if (allocations > 0) {
+    std::fprintf(stderr, "steady-state heap allocations: %llu\n",
+                 static_cast<unsigned long long>(allocations));
+    return 1;
+  }
+  return 0;
+}
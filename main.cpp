@@ -4,11 +4,22 @@
 #include "openglwindow.hpp"
 
 int main(int argc, char **argv) {
+  int exitCode{0};
   try {
+    // Teste de renderizacao: sem monitor, usa o driver offscreen do SDL
+    auto renderTest{RenderTestSettings::fromArguments(argc, argv)};
+    if (renderTest.enabled()) {
+      SDL_setenv("SDL_VIDEODRIVER", "offscreen", 0);
+      renderTest.m_exitCode = &exitCode;
+    }
+
     abcg::Application app(argc, argv);
 
     auto window{std::make_unique<OpenGLWindow>()};
-    window->setOpenGLSettings({.samples = 4});
+    window->setRenderTest(renderTest);
+    // Sem MSAA na janela: as amostras ficam no alvo da cena, escolhidas
+    // pela qualidade adaptativa (ver QualityManager)
+    window->setOpenGLSettings({.samples = 0});
     window->setWindowSettings({.width = 600,
                                .height = 600,
                                .showFPS = false,
@@ -19,5 +30,5 @@ int main(int argc, char **argv) {
     fmt::print(stderr, "{}\n", exception.what());
     return -1;
   }
-  return 0;
+  return exitCode;
 }
\ No newline at end of file
@@ -1,59 +1,100 @@
 #include "openglwindow.hpp"
 
+#include <cppitertools/itertools.hpp>
+#include <fmt/core.h>
+#include <fmt/format.h>
 #include <imgui.h>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iterator>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "abcg.hpp"
 
 void OpenGLWindow::handleEvent(SDL_Event &event) {
+  using Type = InputEvent::Type;
+  const auto key{[&](Type type, Input input) { pushInput({type, input}); }};
+
+  if (event.type == SDL_KEYDOWN || event.type == SDL_KEYUP ||
+      event.type == SDL_MOUSEMOTION) {
+    m_pacer.inputReceived();
+  }
+
   // Keyboard events (Movimentacao do gato via teclado)
   if (event.type == SDL_KEYDOWN) {
     if (event.key.keysym.sym == SDLK_UP || event.key.keysym.sym == SDLK_w)
-      m_gameData.m_input.set(static_cast<size_t>(Input::Up));
+      key(Type::KeyDown, Input::Up);
     if (event.key.keysym.sym == SDLK_DOWN || event.key.keysym.sym == SDLK_s)
-      m_gameData.m_input.set(static_cast<size_t>(Input::Down));
+      key(Type::KeyDown, Input::Down);
     if (event.key.keysym.sym == SDLK_LEFT || event.key.keysym.sym == SDLK_a)
-      m_gameData.m_input.set(static_cast<size_t>(Input::Left));
+      key(Type::KeyDown, Input::Left);
     if (event.key.keysym.sym == SDLK_RIGHT || event.key.keysym.sym == SDLK_d)
-      m_gameData.m_input.set(static_cast<size_t>(Input::Right));
+      key(Type::KeyDown, Input::Right);
+    // Alterna entre desenho instanciado e um draw call por asteroide
+    if (event.key.keysym.sym == SDLK_F2)
+      m_asteroids.m_instanced = !m_asteroids.m_instanced;
+    // Mostra/esconde o perfilador de quadro
+    if (event.key.keysym.sym == SDLK_F3)
+      m_profiler.m_visible = !m_profiler.m_visible;
+    // Liga/desliga a colisao entre asteroides
+    if (event.key.keysym.sym == SDLK_F4)
+      pushInput({Type::AsteroidCollisions});
+    // Inicia/termina a gravacao de uma partida (replay)
+    if (event.key.keysym.sym == SDLK_F5) toggleRecording();
+    // Simulacao na thread de renderizacao ou em uma thread propria
+    if (event.key.keysym.sym == SDLK_F6) toggleSimulationThread();
+    // Mostra/esconde o controle de ritmo de quadros
+    if (event.key.keysym.sym == SDLK_F7) m_pacer.m_visible = !m_pacer.m_visible;
+    // Mostra/esconde o controle de qualidade
+    if (event.key.keysym.sym == SDLK_F8)
+      m_quality.m_visible = !m_quality.m_visible;
+    // Estrelas em pontos ou procedurais (em densidades crescentes)
+    if (event.key.keysym.sym == SDLK_F9) m_starLayers.cycleMode();
   }
   if (event.type == SDL_KEYUP) {
     if (event.key.keysym.sym == SDLK_UP || event.key.keysym.sym == SDLK_w)
-      m_gameData.m_input.reset(static_cast<size_t>(Input::Up));
+      key(Type::KeyUp, Input::Up);
     if (event.key.keysym.sym == SDLK_DOWN || event.key.keysym.sym == SDLK_s)
-      m_gameData.m_input.reset(static_cast<size_t>(Input::Down));
+      key(Type::KeyUp, Input::Down);
     if (event.key.keysym.sym == SDLK_LEFT || event.key.keysym.sym == SDLK_a)
-      m_gameData.m_input.reset(static_cast<size_t>(Input::Left));
+      key(Type::KeyUp, Input::Left);
     if (event.key.keysym.sym == SDLK_RIGHT || event.key.keysym.sym == SDLK_d)
-      m_gameData.m_input.reset(static_cast<size_t>(Input::Right));
+      key(Type::KeyUp, Input::Right);
   }
 
   // Mouse events (movimentacao do gato através do mouse)
   if (event.type == SDL_MOUSEMOTION) {
-    glm::ivec2 mousePosition;
-    SDL_GetMouseState(&mousePosition.x, &mousePosition.y);
+    SDL_GetMouseState(&m_lastMouse.x, &m_lastMouse.y);
+    m_lastMouseTime = FramePacer::Clock::now();
 
-    glm::vec2 position{
-        glm::vec2{(float)mousePosition.x / (m_viewportWidth / 2) - 1,
-                  (float)mousePosition.y / (m_viewportHeight / 2) - 1}};
+    pushInput({Type::Mouse, Input::Up, toGamePosition(m_lastMouse)});
+  }
+}
 
-    position.y = -position.y;
+glm::vec2 OpenGLWindow::toGamePosition(glm::ivec2 mouse) const {
+  glm::vec2 position{
+      glm::vec2{(float)mouse.x / (m_viewportWidth / 2) - 1,
+                (float)mouse.y / (m_viewportHeight / 2) - 1}};
 
-    // Define limites para posição do gato
-    if (position.x > -(1 - m_cat.m_scale) && position.x < (1 - m_cat.m_scale))
-      m_cat.m_translation.x = position.x;
-    if (position.y > -(1 - m_cat.m_scale) && position.y < (1 - m_cat.m_scale))
-      m_cat.m_translation.y = position.y;
-  }
+  position.y = -position.y;
+  return position;
 }
 
-//Funcao para resetar todas as keys caso jogo acabe enquanto elas estão pressionadas
-void OpenGLWindow::resetKeys(){
-  m_gameData.m_input.reset(static_cast<size_t>(Input::Up));
-  m_gameData.m_input.reset(static_cast<size_t>(Input::Down));
-  m_gameData.m_input.reset(static_cast<size_t>(Input::Left));
-  m_gameData.m_input.reset(static_cast<size_t>(Input::Right));
+// Entradas vao direto para a simulacao ou, com a thread ativa, para a fila
+// dela. Se a fila estiver cheia, o evento espera em m_overflow ate o
+// proximo flush(); nenhuma entrada e descartada (ver SimulationThread::push)
+void OpenGLWindow::pushInput(const InputEvent &event) {
+  if (m_simulationThread.running()) {
+    m_simulationThread.push(event);
+  } else {
+    m_simulation.handleInput(event);
+  }
 }
 
 void OpenGLWindow::initializeGL() {
@@ -65,110 +106,232 @@ void OpenGLWindow::initializeGL() {
     throw abcg::Exception{abcg::Exception::Runtime("Cannot load font file")};
   }
 
+  // Os programas vem do cache de binarios quando possivel
+  auto *prefPath{SDL_GetPrefPath("CatRun", "shadercache")};
+  m_programCache.initialize(prefPath != nullptr ? prefPath : "shadercache");
+  SDL_free(prefPath);
+
+  // <nome>.vert e <nome>.frag; a janela fica dona do programa
+  const auto loadProgram{[&](const std::string &name,
+                             const std::vector<std::string> &defines = {}) {
+    return GLProgram{GLResourceRegistry::Owner::Programs,
+                     m_programCache.load(getAssetsPath() + name + ".vert",
+                                         getAssetsPath() + name + ".frag",
+                                         defines)};
+  }};
+
   // Programa para renderizar estrelas
-  m_starsProgram = createProgramFromFile(getAssetsPath() + "stars.vert",
-                                         getAssetsPath() + "stars.frag");
+  m_starsProgram = loadProgram("stars");
+  // Variante de tela inteira, com estrelas procedurais
+  m_proceduralStarsProgram = loadProgram("stars", {"PROCEDURAL"});
   // Programa para renderizar objetos
-  m_objectsProgram = createProgramFromFile(getAssetsPath() + "objects.vert",
-                                           getAssetsPath() + "objects.frag");
+  m_objectsProgram = loadProgram("objects");
+  // Variante com atributos por instancia (asteroides)
+  m_instancedObjectsProgram = loadProgram("objects", {"INSTANCED"});
+  // Formas redondas por campo de distancia (nuvens)
+  m_sdfProgram = loadProgram("sdf");
 
   abcg::glClearColor(0.2f, 0.5f, 0.9f, 1);
 
+  // Os uniformes guardados no cache pertencem aos programas anteriores
+  m_renderQueue.clearStateCache();
+
 #if !defined(__EMSCRIPTEN__)
   abcg::glEnable(GL_PROGRAM_POINT_SIZE);
 #endif
 
-  m_starLayers.initializeGL(m_starsProgram, 25);
-  m_clouds.initializeGL(m_objectsProgram, 3);
+  // Inicia a simulacao com uma semente pseudo-aleatoria (fixa no teste de
+  // renderizacao)
+  const auto seed{m_renderTest.enabled()
+                      ? m_renderTest.m_seed
+                      : static_cast<unsigned>(std::chrono::steady_clock::now()
+                                                  .time_since_epoch()
+                                                  .count())};
+  m_simulation.initialize(seed);
+  m_randomEngine.seed(seed + 1);
+
+  m_starLayers.initializeGL(m_starsProgram, m_proceduralStarsProgram,
+                            QualityManager::m_levels[0].m_starDensity,
+                            m_randomEngine());
+  m_clouds.initializeGL(m_sdfProgram, 3, m_frameArena);
   m_cat.initializeGL(m_objectsProgram);
-  m_asteroids.initializeGL(m_objectsProgram, 1);
+  m_asteroids.initializeGL(m_objectsProgram, m_instancedObjectsProgram,
+                           m_simulation.m_shapes);
+  m_profiler.initializeGL();
+  m_streamBuffer.initializeGL(1 << 20);
+
+  if (m_renderTest.enabled()) {
+    m_offscreen.initializeGL(m_renderTest.m_width, m_renderTest.m_height);
+    m_profiler.m_synchronous = true;
+  }
+
+  updateFrameState();
 }
 
-// Função de restart do jogo
+// Função de restart do jogo. Reaproveita todos os recursos OpenGL: so o
+// estado da simulacao e as posicoes das estrelas sao sorteados de novo
 void OpenGLWindow::restart() {
-  m_rounds = 0;
-  m_pedras_desviadas = 0;
-  m_ScreenTimer.restart();
-  m_gameTimer.restart();
-  resetKeys();
-  m_gameData.m_state = State::Playing;
-  m_starLayers.initializeGL(m_starsProgram, 25);
-  m_clouds.initializeGL(m_objectsProgram, 3);
-  m_cat.initializeGL(m_objectsProgram);
-  m_asteroids.initializeGL(m_objectsProgram, 1);
+  // Aplicado no inicio do proximo passo, para poder ser gravado no replay
+  pushInput({InputEvent::Type::Restart});
+  m_starLayers.reset(m_randomEngine());
 }
 
 void OpenGLWindow::update() {
+  ProfileScope scope{m_profiler, FrameProfiler::Section::Update};
   const float deltaTime{static_cast<float>(getDeltaTime())};
 
-  m_cat.update(m_gameData, deltaTime);
-  m_asteroids.update(deltaTime, &m_pedras_desviadas);
-  float interval;
-
-  // define parametros para ordenacao de asteroids gerados
-  std::uniform_real_distribution<float> m_randomDist{-1.0f, 1.0f};
-  int ordenation = signbit(m_randomDist(m_randomEngine));
-  int starting_point = 1;
-  if (ordenation) starting_point = -1;
-
-  if (m_gameData.m_state == State::Playing) {
-    // controla tamanho do intervalo de acordo com tempo passado, baseado no
-    // tempo total definido no arquivo .hpp
-    if (m_total_time - m_ScreenTimer.elapsed() < m_total_time / 2.0f &&
-        m_total_time - m_ScreenTimer.elapsed() > m_total_time / 6.0f) {
-      interval = 0.75f;
-    } else if (m_total_time - m_ScreenTimer.elapsed() < m_total_time / 6.0f) {
-      interval = 1.2f;
-    } else {
-      interval = 1.0f;
-    }
-
-    // cria asteroides a cada intervalo, modificando sua velocidade segundo o
-    // tempo
-    if (m_gameTimer.elapsed() > interval) {
-      m_gameTimer.restart();
-      std::generate_n(std::back_inserter(m_asteroids.m_asteroids), 1, [&]() {
-        float inverse_velocity =
-            (float)(m_total_time - m_ScreenTimer.elapsed()) /
-            (m_total_time / 5.0f);
-        return m_asteroids.createAsteroid(
-            glm::vec2{m_randomDist(m_randomEngine), starting_point},
-            inverse_velocity, ordenation);
-      });
-    }
+  // A simulacao roda em passo fixo, independente da taxa de quadros. Com a
+  // thread ativa ela avanca sozinha; so as entradas em espera sao reenviadas
+  if (m_simulationThread.running()) {
+    m_simulationThread.flush();
+  } else {
+    m_simulation.advance(deltaTime);
+  }
+  m_starLayers.update(deltaTime);
+  updateFrameState();
+}
 
-    checkCollisions();
-    checkWinCondition();
-  } else if (m_gameTimer.elapsed() > 5.0f) {
-    m_gameTimer.restart();
-    std::generate_n(std::back_inserter(m_asteroids.m_asteroids), 3, [&]() {
-      return m_asteroids.createAsteroid(
-          glm::vec2{m_randomDist(m_randomEngine), starting_point}, 5.5f,
-          ordenation);
-    });
+void OpenGLWindow::updateFrameState() {
+  if (m_simulationThread.running()) {
+    const auto &snapshot{m_simulationThread.acquire()};
+    m_frame = {&snapshot.m_gameData,     &snapshot.m_cat,
+               &snapshot.m_asteroids,    snapshot.m_pedras_desviadas,
+               snapshot.m_remainingTime, m_simulationThread.alpha()};
+    return;
   }
+
+  m_frame = {&m_simulation.m_gameData,     &m_simulation.m_cat,
+             &m_simulation.m_asteroids,    m_simulation.m_pedras_desviadas,
+             m_simulation.remainingTime(), m_simulation.alpha()};
 }
 
 void OpenGLWindow::paintGL() {
+  if (m_renderTest.enabled()) {
+    runRenderTest();
+    return;
+  }
+
+  m_pacer.beginFrame();
+  const auto frameStart{FramePacer::Clock::now()};
+  m_profiler.beginFrame();
+  if (m_quality.m_adaptive) m_profiler.requireGpuTiming();
+  m_streamBuffer.beginFrame();
+  m_frameArena.reset();
+
   update();
 
+  applyQuality();
+  m_sceneTarget.bind();
+  paintScene();
+  m_sceneTarget.present(m_viewportWidth, m_viewportHeight);
+
+  m_streamBuffer.endFrame();
+
+  // Custo do quadro: o trabalho de CPU ate aqui (sem a espera do ritmo de
+  // quadros nem o VSync) ou o tempo de GPU da cena, o que for maior
+  const auto cpuTime{std::chrono::duration<float, std::milli>{
+      FramePacer::Clock::now() - frameStart}.count()};
+  m_quality.update(std::max(cpuTime, m_profiler.gpuSceneTime()),
+                   m_pacer.m_targetFps);
+}
+
+// Ajusta o alvo da cena e a densidade de estrelas ao nivel de qualidade
+// atual; nao faz nada se o nivel e o tamanho da janela nao mudaram
+void OpenGLWindow::applyQuality() {
+  const auto &level{m_quality.level()};
+  const auto scaled{[&](int size) {
+    return static_cast<GLsizei>(
+        std::lround(static_cast<float>(size) * level.m_resolutionScale));
+  }};
+  m_sceneTarget.configure(scaled(m_viewportWidth), scaled(m_viewportHeight),
+                          level.m_samples);
+  m_starLayers.setDensity(level.m_starDensity);
+}
+
+// Desenha todos os passes no framebuffer e viewport atuais. Os modulos
+// enviam pacotes para a fila, que os executa ordenados; cada camada e medida
+// na secao correspondente do perfilador
+void OpenGLWindow::paintScene() {
   abcg::glClear(GL_COLOR_BUFFER_BIT);
-  abcg::glViewport(0, 0, m_viewportWidth, m_viewportHeight);
 
-  m_starLayers.paintGL();
-  m_clouds.paintGL();
-  m_asteroids.paintGL();
-  m_cat.paintGL(m_gameData);
+  m_starLayers.paintGL(m_renderQueue);
+  m_clouds.paintGL(m_renderQueue);
+  m_asteroids.paintGL(*m_frame.m_asteroids, m_frame.m_alpha, m_streamBuffer,
+                      m_renderQueue);
+  if (m_pacer.m_lowLatency) {
+    m_cat.paintGL(*m_frame.m_gameData, latchedCat(), 1.0f, m_renderQueue);
+  } else {
+    m_cat.paintGL(*m_frame.m_gameData, *m_frame.m_cat, m_frame.m_alpha,
+                  m_renderQueue);
+  }
+
+  m_renderQueue.execute(m_profiler);
+  m_pacer.inputSubmitted();
+}
+
+// Modo de baixa latencia: parte do ultimo passo da simulacao, em vez de
+// interpolar um passo atras, e aplica as entradas mais recentes do SDL,
+// amostradas logo antes de desenhar o gato. So afeta o desenho; a simulacao
+// recebe as mesmas entradas pelos eventos, no proximo handleEvent
+CatState OpenGLWindow::latchedCat() {
+  SDL_PumpEvents();
+  auto cat{*m_frame.m_cat};
+
+  // Teclado: avanca o gato pelo tempo ja decorrido desde o ultimo passo
+  GameData latest;
+  const auto *keys{SDL_GetKeyboardState(nullptr)};
+  const auto latch{[&](Input input, SDL_Scancode arrow, SDL_Scancode letter) {
+    if (keys[arrow] || keys[letter]) {
+      latest.m_input.set(static_cast<size_t>(input));
+    }
+  }};
+  latch(Input::Up, SDL_SCANCODE_UP, SDL_SCANCODE_W);
+  latch(Input::Down, SDL_SCANCODE_DOWN, SDL_SCANCODE_S);
+  latch(Input::Left, SDL_SCANCODE_LEFT, SDL_SCANCODE_A);
+  latch(Input::Right, SDL_SCANCODE_RIGHT, SDL_SCANCODE_D);
+  cat.update(latest, m_frame.m_alpha * m_simulation.fixedDeltaTime());
+
+  // Mouse: segue a posicao atual enquanto ele se move (e por um instante
+  // depois, ate a simulacao receber o ultimo movimento)
+  glm::ivec2 mouse;
+  SDL_GetMouseState(&mouse.x, &mouse.y);
+  const auto now{FramePacer::Clock::now()};
+  if (mouse != m_lastMouse) {
+    m_pacer.inputReceived(now);
+    m_lastMouse = mouse;
+    m_lastMouseTime = now;
+  }
+  if (now - m_lastMouseTime < std::chrono::milliseconds{50}) {
+    cat.moveTo(toGamePosition(mouse));
+  }
+
+  cat.storePrevious();
+  return cat;
 }
 
 void OpenGLWindow::paintUI() {
   abcg::OpenGLWindow::paintUI();
+  {
+    // So mede a construcao da interface do jogo; o desenho do ImGui e feito
+    // pela abcg depois do paintUI
+    ProfileScope scope{m_profiler, FrameProfiler::Section::UI};
+    paintGameUI();
+  }
+  m_profiler.paintUI(m_frameArena);
+  m_pacer.paintUI();
+  m_quality.paintUI();
+}
+
+void OpenGLWindow::paintGameUI() {
   // texto que aparece durante o game
-  if (m_gameData.m_state == State::Playing) {
-    std::string s = std::to_string(m_pedras_desviadas);
+  if (m_frame.m_gameData->m_state == State::Playing) {
+    // Textos montados na memoria do quadro, sem alocar no heap
+    std::pmr::string s{&m_frameArena};
+    fmt::format_to(std::back_inserter(s), "{}", m_frame.m_pedras_desviadas);
     char const *pchar = s.c_str();
 
-    std::string s2 = std::to_string(m_total_time - m_ScreenTimer.elapsed());
+    std::pmr::string s2{&m_frameArena};
+    fmt::format_to(std::back_inserter(s2), "{:f}", m_frame.m_remainingTime);
     char const *pchar2 = s2.c_str();
 
     // definições do imgui
@@ -223,7 +386,7 @@ void OpenGLWindow::paintUI() {
     ImGui::PushFont(m_font);
 
     // Define texto e botoes para cada estado de jogo (inicial, win e game over)
-    if (m_gameData.m_state == State::Initial) {
+    if (m_frame.m_gameData->m_state == State::Initial) {
       ImGui::Text("    *Cat run!*");
       ImGui::RadioButton("Dia", &m_mode, 0);
       ImGui::RadioButton("Noite", &m_mode, 1);
@@ -237,7 +400,7 @@ void OpenGLWindow::paintUI() {
       }
     }
 
-    if (m_gameData.m_state == State::GameOver) {
+    if (m_frame.m_gameData->m_state == State::GameOver) {
       ImGui::Text("    *Game Over!*");
 
       ImGui::RadioButton("Dia", &m_mode, 0);
@@ -249,7 +412,7 @@ void OpenGLWindow::paintUI() {
       if (ImGui::IsItemClicked()) {
         restart();
       }
-    } else if (m_gameData.m_state == State::Win) {
+    } else if (m_frame.m_gameData->m_state == State::Win) {
       ImGui::Text("    *You Win!*");
 
       ImGui::RadioButton("Dia", &m_mode, 0);
@@ -276,38 +439,28 @@ void OpenGLWindow::resizeGL(int width, int height) {
 }
 
 void OpenGLWindow::terminateGL() {
-  abcg::glDeleteProgram(m_starsProgram);
-  abcg::glDeleteProgram(m_objectsProgram);
-
+  if (m_recorder.recording()) toggleRecording();
+  m_simulationThread.stop();
+
+  m_starsProgram.reset();
+  m_proceduralStarsProgram.reset();
+  m_objectsProgram.reset();
+  m_instancedObjectsProgram.reset();
+  m_sdfProgram.reset();
+
+  m_profiler.terminateGL();
+  m_streamBuffer.terminateGL();
+  m_offscreen.terminateGL();
+  m_sceneTarget.terminateGL();
   m_asteroids.terminateGL();
   m_cat.terminateGL();
   m_clouds.terminateGL();
   m_starLayers.terminateGL();
-}
 
-// Funcao para checar colisao entre o gato e os asteroides e para destruir
-// asteroides que sairem da tela
-void OpenGLWindow::checkCollisions() {
-  // Verifica a colisão entre gato e asteróides
-  for (const auto &asteroid : m_asteroids.m_asteroids) {
-    const auto asteroidTranslation{asteroid.m_translation};
-    const auto distance{
-        glm::distance(m_cat.m_translation, asteroidTranslation)};
-
-    if (distance < m_cat.m_scale * 0.9f + asteroid.m_scale * 0.85f) {
-      m_gameData.m_state = State::GameOver;
-    }
-  }
-
-  m_asteroids.m_asteroids.remove_if(
-      [](const Asteroids::Asteroid &a) { return a.m_hit; });
-}
-
-// Funcao para checar se o tempo total de jogo passou (vitoria)
-void OpenGLWindow::checkWinCondition() {
-  if (m_ScreenTimer.elapsed() >= m_total_time &&
-      m_gameData.m_state == State::Playing) {
-    m_gameData.m_state = State::Win;
+  // Tudo que foi criado pelos modulos ja deve ter sido liberado
+  const auto leaks{GLResourceRegistry::reportLeaks()};
+  if (leaks > 0 && m_exitCode != nullptr) {
+    *m_exitCode = 1;
   }
 }
 
@@ -330,13 +483,183 @@ void OpenGLWindow::decide_mode(int mode) {
   }
 
   m_cat.m_color = cat_color;
-  for (auto &asteroid : m_asteroids.m_asteroids) {
-    asteroid.m_color = asteroid_color;
-  }
   m_asteroids.m_color_asteroids = asteroid_color;
 
-  for (auto &cloud : m_clouds.m_clouds) {
-    cloud.m_color = cloud_color;
-  }
   m_clouds.m_cloud_color = cloud_color;
-}
\ No newline at end of file
+}
+
+// Comeca uma partida gravada ou termina a gravacao atual, salvando o replay
+// em catrun.replay (reproduzido com catrun_headless --replay)
+void OpenGLWindow::toggleRecording() {
+  // O gravador mexe na simulacao; a thread e pausada durante a troca
+  const auto threaded{m_simulationThread.running()};
+  m_simulationThread.stop();
+  toggleRecordingState();
+  if (threaded) m_simulationThread.start(m_simulation);
+  updateFrameState();
+}
+
+void OpenGLWindow::toggleRecordingState() {
+  if (!m_recorder.recording()) {
+    m_randomEngine.seed(static_cast<unsigned>(
+        std::chrono::steady_clock::now().time_since_epoch().count()));
+    const auto roundSeed{static_cast<unsigned>(m_randomEngine())};
+    const auto starsSeed{static_cast<unsigned>(m_randomEngine())};
+
+    m_recorder.begin(m_simulation, roundSeed, starsSeed);
+    m_randomEngine.seed(starsSeed);
+    m_starLayers.reset(m_randomEngine());
+    return;
+  }
+
+  m_recorder.end(m_simulation);
+  const std::string path{"catrun.replay"};
+  if (m_recorder.save(path)) {
+    fmt::print("Replay salvo em {} ({} passos)\n", path, m_recorder.ticks());
+  } else {
+    fmt::print(stderr, "Nao foi possivel salvar {}\n", path);
+  }
+}
+
+// Liga/desliga a thread de simulacao. Ao desligar, a simulacao continua do
+// ultimo passo executado pela thread
+void OpenGLWindow::toggleSimulationThread() {
+#if defined(__EMSCRIPTEN__)
+  // Sem suporte a threads no build para a web
+  return;
+#else
+  if (m_simulationThread.running()) {
+    m_simulationThread.stop();
+    fmt::print("Simulacao na thread de renderizacao\n");
+  } else {
+    m_simulationThread.start(m_simulation);
+    fmt::print("Simulacao em thread propria ({} passos/s)\n",
+               m_simulation.tickRate());
+  }
+  updateFrameState();
+#endif
+}
+
+// Desenha a cena fixa do teste nos dois temas, salva e compara as imagens e
+// imprime o tempo medio de cada passe. Depois encerra a aplicacao
+void OpenGLWindow::runRenderTest() {
+  using Section = FrameProfiler::Section;
+  const auto settings{m_renderTest};
+  m_renderTest = {};
+
+  // Partida com a semente do teste, avancada um numero fixo de passos
+  m_simulation.initialize(settings.m_seed);
+  m_simulation.restart();
+  for ([[maybe_unused]] auto tick : iter::range(settings.m_ticks)) {
+    m_simulation.update(m_simulation.fixedDeltaTime());
+  }
+  m_starLayers.reset(settings.m_seed);
+  updateFrameState();
+
+  std::filesystem::create_directories(settings.m_outputDir);
+  if (settings.m_updateGolden) {
+    std::filesystem::create_directories(settings.m_goldenDir);
+  }
+
+  constexpr std::array passes{std::pair{Section::Stars, "stars"},
+                              std::pair{Section::Clouds, "clouds"},
+                              std::pair{Section::Asteroids, "asteroids"},
+                              std::pair{Section::Cat, "cat"}};
+
+  bool passed{true};
+  constexpr std::array themes{std::pair{0, "dia"}, std::pair{1, "noite"}};
+  for (const auto &[mode, theme] : themes) {
+    decide_mode(mode);
+    m_offscreen.bind();
+    m_profiler.resetHistory();
+    for ([[maybe_unused]] auto frame : iter::range(settings.m_frames)) {
+      m_profiler.beginFrame();
+      m_streamBuffer.beginFrame();
+      m_frameArena.reset();
+      paintScene();
+      m_streamBuffer.endFrame();
+    }
+    const auto image{m_offscreen.read()};
+    m_offscreen.unbind();
+
+    fmt::print("{}:", theme);
+    for (const auto &[section, name] : passes) {
+      fmt::print(" {} {:.3f} ms", name, m_profiler.cpuAverage(section));
+    }
+    fmt::print("\n");
+
+    const auto file{std::string{theme} + ".ppm"};
+    const auto output{std::filesystem::path{settings.m_outputDir} / file};
+    const auto golden{std::filesystem::path{settings.m_goldenDir} / file};
+    if (!image.savePpm(output.string())) {
+      fmt::print(stderr, "Nao foi possivel salvar {}\n", output.string());
+      passed = false;
+    }
+
+    if (settings.m_updateGolden) {
+      passed = image.savePpm(golden.string()) && passed;
+      continue;
+    }
+
+    Image reference;
+    if (!reference.loadPpm(golden.string())) {
+      fmt::print(stderr, "  {}: imagem de referencia ausente\n",
+                 golden.string());
+      passed = false;
+      continue;
+    }
+    const auto difference{
+        compareImages(image, reference, settings.m_tolerance)};
+    const auto ok{!difference.m_sizeMismatch &&
+                  difference.mismatchedFraction() <= settings.m_maxMismatch};
+    fmt::print("  {} (diferenca maxima {}, {:.4f}% dos pixels)\n",
+               ok ? "ok" : "DIFERENTE", difference.m_maxChannelDifference,
+               difference.mismatchedFraction() * 100.0f);
+    passed = passed && ok;
+  }
+
+  passed = benchmarkRestart(settings) && passed;
+
+  if (settings.m_exitCode != nullptr) *settings.m_exitCode = passed ? 0 : 1;
+  m_profiler.m_synchronous = false;
+
+  SDL_Event quit{};
+  quit.type = SDL_QUIT;
+  SDL_PushEvent(&quit);
+}
+
+// Restart pelo caminho da janela: restart() (que tambem sorteia as estrelas
+// de novo em StarLayers::reset), o passo que aplica o restart na simulacao e
+// o primeiro quadro depois dele, com glFinish para incluir o envio a GPU.
+// Reprova se o numero de objetos GL vivos mudar
+bool OpenGLWindow::benchmarkRestart(const RenderTestSettings &settings) {
+  const auto objectsBefore{GLResourceRegistry::liveObjects()};
+
+  m_offscreen.bind();
+  std::chrono::duration<double, std::milli> elapsed{};
+  for ([[maybe_unused]] auto iteration : iter::range(settings.m_restarts)) {
+    const auto start{FramePacer::Clock::now()};
+    restart();
+    m_simulation.update(m_simulation.fixedDeltaTime());
+    updateFrameState();
+
+    m_profiler.beginFrame();
+    m_streamBuffer.beginFrame();
+    m_frameArena.reset();
+    paintScene();
+    m_streamBuffer.endFrame();
+    abcg::glFinish();
+    elapsed += FramePacer::Clock::now() - start;
+  }
+  m_offscreen.unbind();
+
+  const auto objectsAfter{GLResourceRegistry::liveObjects()};
+  fmt::print("restart: {:.3f} ms (media de {}), objetos GL {} -> {}\n",
+             elapsed.count() / std::max(1, settings.m_restarts),
+             settings.m_restarts, objectsBefore, objectsAfter);
+  if (objectsAfter != objectsBefore) {
+    fmt::print(stderr, "  o restart criou ou liberou objetos GL\n");
+    return false;
+  }
+  return true;
+}
@@ -9,9 +9,28 @@
 #include "asteroids.hpp"
 #include "cat.hpp"
 #include "clouds.hpp"
+#include "framearena.hpp"
+#include "framepacer.hpp"
+#include "glresource.hpp"
+#include "profiler.hpp"
+#include "programcache.hpp"
+#include "qualitymanager.hpp"
+#include "renderqueue.hpp"
+#include "rendertest.hpp"
+#include "replay.hpp"
+#include "scenetarget.hpp"
+#include "simulation.hpp"
+#include "simulationthread.hpp"
 #include "starlayers.hpp"
+#include "streambuffer.hpp"
 
 class OpenGLWindow : public abcg::OpenGLWindow {
+ public:
+  void setRenderTest(RenderTestSettings settings) {
+    m_exitCode = settings.m_exitCode;
+    m_renderTest = std::move(settings);
+  }
+
  protected:
   void handleEvent(SDL_Event& event) override;
   void initializeGL() override;
@@ -21,38 +40,91 @@ class OpenGLWindow : public abcg::OpenGLWindow {
   void terminateGL() override;
 
  private:
-  GLuint m_starsProgram{};
-  GLuint m_objectsProgram{};
+  GLProgram m_starsProgram;
+  GLProgram m_proceduralStarsProgram;
+  GLProgram m_objectsProgram;
+  GLProgram m_instancedObjectsProgram;
+  GLProgram m_sdfProgram;
+  ProgramCache m_programCache;
 
   int m_viewportWidth{};
   int m_viewportHeight{};
-  int m_rounds{0};
-  int m_pedras_desviadas{0};
   int m_mode{0};
-  const int m_total_time{60};
 
-  GameData m_gameData;
+  // Estado do jogo; os renderizadores abaixo apenas leem dele
+  Simulation m_simulation;
+  ReplayRecorder m_recorder;
+
+  // Opcional (F6): roda m_simulation em uma thread propria. Enquanto ativa,
+  // a janela so envia entradas pela fila e le os snapshots publicados
+  SimulationThread m_simulationThread;
+
+  // Estado lido pelo desenho e pela interface neste quadro: a propria
+  // m_simulation ou o ultimo snapshot da thread
+  struct FrameState {
+    const GameData *m_gameData{};
+    const CatState *m_cat{};
+    const AsteroidPool *m_asteroids{};
+    int m_pedras_desviadas{};
+    float m_remainingTime{};
+    float m_alpha{};
+  } m_frame;
 
   Asteroids m_asteroids;
   Cat m_cat;
   StarLayers m_starLayers;
   Clouds m_clouds;
 
-  abcg::ElapsedTimer m_gameTimer;
-  abcg::ElapsedTimer m_ScreenTimer;
+  FrameProfiler m_profiler;
+  FramePacer m_pacer;
+
+  // Qualidade adaptativa (F8): a cena e desenhada em m_sceneTarget, na
+  // resolucao e com o MSAA do nivel atual, e ampliada para a janela
+  QualityManager m_quality;
+  SceneTarget m_sceneTarget;
+
+  // Ultima posicao do mouse (pixels) e quando ela mudou, para o modo de
+  // baixa latencia
+  glm::ivec2 m_lastMouse{};
+  FramePacer::Clock::time_point m_lastMouseTime;
+
+  // Teste de renderizacao fora da tela (ver rendertest.hpp)
+  RenderTestSettings m_renderTest;
+  // Codigo de saida do teste; sobrevive ao fim do teste (m_renderTest e
+  // limpo) para que o terminateGL possa reprovar vazamentos
+  int* m_exitCode{};
+  OffscreenTarget m_offscreen;
+
+  // Pacotes de desenho do quadro, ordenados e executados em paintScene()
+  RenderQueue m_renderQueue;
+
+  // Dados dinamicos de cada quadro (ex.: instancias dos asteroides)
+  StreamBuffer m_streamBuffer;
+
+  // Memoria temporaria do quadro, liberada no inicio do paintGL
+  FrameArena m_frameArena;
 
   ImFont* m_font{};
 
+  // Sementes das estrelas (nao afetam a simulacao)
   std::default_random_engine m_randomEngine;
 
-  void resetKeys();
-
-  void checkCollisions();
-  void checkWinCondition();
   void decide_mode(int mode);
+  void paintGameUI();
+  void toggleRecording();
+  void toggleRecordingState();
+  void toggleSimulationThread();
+  void pushInput(const InputEvent& event);
+  void updateFrameState();
+  [[nodiscard]] glm::vec2 toGamePosition(glm::ivec2 mouse) const;
+  CatState latchedCat();
 
+  void applyQuality();
   void restart();
   void update();
+  void paintScene();
+  void runRenderTest();
+  bool benchmarkRestart(const RenderTestSettings& settings);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include "overlapkernel.hpp"
+
+#include <algorithm>
+#include <bitset>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define OVERLAP_X86 1
+#include <immintrin.h>
+#endif
+
+// AVX2 compilado so nesta funcao (atributo target), sem exigir -mavx2 no
+// projeto inteiro; a CPU e consultada antes de usa-lo
+#if defined(OVERLAP_X86) && (defined(__GNUC__) || defined(__clang__))
+#define OVERLAP_AVX2 1
+#endif
+
+static_assert(sizeof(glm::vec2) == 2 * sizeof(float));
+
+namespace {
+// Testa os circulos [first, count) um a um. Tambem completa o final dos
+// caminhos vetorizados
+void overlapScalar(glm::vec2 center, float radius, const glm::vec2 *centers,
+                   const float *scales, float scaleFactor, std::size_t first,
+                   std::size_t count, std::uint64_t *hits) {
+  for (auto index{first}; index < count; ++index) {
+    const auto offset{centers[index] - center};
+    const auto distance{radius + scales[index] * scaleFactor};
+    if (offset.x * offset.x + offset.y * offset.y < distance * distance) {
+      hits[index / 64] |= std::uint64_t{1} << (index % 64);
+    }
+  }
+}
+
+#if defined(OVERLAP_X86)
+// 4 circulos por iteracao. Os centros estao intercalados (x, y), entao
+// dois loads sao separados em um vetor de x e outro de y
+std::size_t overlapSse2(glm::vec2 center, float radius,
+                        const glm::vec2 *centers, const float *scales,
+                        float scaleFactor, std::size_t count,
+                        std::uint64_t *hits) {
+  const auto *data{reinterpret_cast<const float *>(centers)};
+  const auto centerX{_mm_set1_ps(center.x)};
+  const auto centerY{_mm_set1_ps(center.y)};
+  const auto queryRadius{_mm_set1_ps(radius)};
+  const auto factor{_mm_set1_ps(scaleFactor)};
+
+  std::size_t index{0};
+  for (; index + 4 <= count; index += 4) {
+    const auto low{_mm_loadu_ps(data + index * 2)};
+    const auto high{_mm_loadu_ps(data + index * 2 + 4)};
+    const auto dx{_mm_sub_ps(
+        _mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0)), centerX)};
+    const auto dy{_mm_sub_ps(
+        _mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1)), centerY)};
+    const auto squared{_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy))};
+
+    const auto distance{_mm_add_ps(
+        queryRadius, _mm_mul_ps(_mm_loadu_ps(scales + index), factor))};
+    const auto mask{static_cast<std::uint64_t>(_mm_movemask_ps(
+        _mm_cmplt_ps(squared, _mm_mul_ps(distance, distance))))};
+    hits[index / 64] |= mask << (index % 64);
+  }
+  return index;
+}
+#endif
+
+#if defined(OVERLAP_AVX2)
+// O shuffle de 256 bits trabalha em cada metade: os pares de x (e de y)
+// saem na ordem 0 1 4 5 2 3 6 7 e sao reordenados com permute4x64
+__attribute__((target("avx2"))) inline __m256 inOrder(__m256 pairs) {
+  return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(pairs),
+                                                _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+// 8 circulos por iteracao
+__attribute__((target("avx2"))) std::size_t overlapAvx2(
+    glm::vec2 center, float radius, const glm::vec2 *centers,
+    const float *scales, float scaleFactor, std::size_t count,
+    std::uint64_t *hits) {
+  const auto *data{reinterpret_cast<const float *>(centers)};
+  const auto centerX{_mm256_set1_ps(center.x)};
+  const auto centerY{_mm256_set1_ps(center.y)};
+  const auto queryRadius{_mm256_set1_ps(radius)};
+  const auto factor{_mm256_set1_ps(scaleFactor)};
+
+  std::size_t index{0};
+  for (; index + 8 <= count; index += 8) {
+    const auto low{_mm256_loadu_ps(data + index * 2)};
+    const auto high{_mm256_loadu_ps(data + index * 2 + 8)};
+    const auto dx{_mm256_sub_ps(
+        inOrder(_mm256_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0))),
+        centerX)};
+    const auto dy{_mm256_sub_ps(
+        inOrder(_mm256_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1))),
+        centerY)};
+    // Sem FMA, para dar exatamente o mesmo resultado dos outros caminhos
+    const auto squared{
+        _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy))};
+
+    const auto distance{_mm256_add_ps(
+        queryRadius, _mm256_mul_ps(_mm256_loadu_ps(scales + index), factor))};
+    const auto mask{static_cast<std::uint64_t>(_mm256_movemask_ps(
+        _mm256_cmp_ps(squared, _mm256_mul_ps(distance, distance),
+                      _CMP_LT_OQ)))};
+    hits[index / 64] |= mask << (index % 64);
+  }
+  return index;
+}
+#endif
+}  // namespace
+
+bool simdPathSupported(SimdPath path) {
+  switch (path) {
+    case SimdPath::Scalar:
+      return true;
+    case SimdPath::Sse2:
+#if defined(OVERLAP_X86)
+      return true;
+#else
+      return false;
+#endif
+    case SimdPath::Avx2:
+#if defined(OVERLAP_AVX2)
+      return __builtin_cpu_supports("avx2") != 0;
+#else
+      return false;
+#endif
+  }
+  return false;
+}
+
+SimdPath bestSimdPath() {
+  static const auto best{[] {
+    for (const auto path : {SimdPath::Avx2, SimdPath::Sse2}) {
+      if (simdPathSupported(path)) return path;
+    }
+    return SimdPath::Scalar;
+  }()};
+  return best;
+}
+
+const char *simdPathName(SimdPath path) {
+  switch (path) {
+    case SimdPath::Scalar:
+      return "scalar";
+    case SimdPath::Sse2:
+      return "sse2";
+    case SimdPath::Avx2:
+      return "avx2";
+  }
+  return "";
+}
+
+std::size_t overlapCircles(glm::vec2 center, float radius,
+                           const glm::vec2 *centers, const float *scales,
+                           float scaleFactor, std::size_t count,
+                           std::uint64_t *hits, SimdPath path) {
+  std::fill(hits, hits + overlapMaskWords(count), 0);
+
+  std::size_t first{0};
+#if defined(OVERLAP_AVX2)
+  if (path == SimdPath::Avx2) {
+    first = overlapAvx2(center, radius, centers, scales, scaleFactor, count,
+                        hits);
+  }
+#endif
+#if defined(OVERLAP_X86)
+  if (path == SimdPath::Sse2) {
+    first = overlapSse2(center, radius, centers, scales, scaleFactor, count,
+                        hits);
+  }
+#endif
+  overlapScalar(center, radius, centers, scales, scaleFactor, first, count,
+                hits);
+
+  std::size_t total{0};
+  for (std::size_t word{0}; word < overlapMaskWords(count); ++word) {
+    total += std::bitset<64>{hits[word]}.count();
+  }
+  return total;
+}
@@ -0,0 +1,31 @@
+#ifndef OVERLAPKERNEL_HPP_
+#define OVERLAPKERNEL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/vec2.hpp>
+
+// Implementacoes do teste de sobreposicao. A melhor suportada pela CPU e
+// escolhida em tempo de execucao; as outras podem ser forcadas (bench.cpp)
+enum class SimdPath { Scalar, Sse2, Avx2 };
+
+[[nodiscard]] SimdPath bestSimdPath();
+[[nodiscard]] bool simdPathSupported(SimdPath path);
+[[nodiscard]] const char *simdPathName(SimdPath path);
+
+// Numero de palavras de 64 bits da mascara de count circulos
+[[nodiscard]] constexpr std::size_t overlapMaskWords(std::size_t count) {
+  return (count + 63) / 64;
+}
+
+// Testa o circulo (center, radius) contra count circulos com centros em
+// centers e raios scales[i] * scaleFactor, comparando distancias ao quadrado
+// (sem raiz). O bit i de hits (overlapMaskWords(count) palavras) indica se o
+// circulo i sobrepoe; retorna quantos sobrepoem. path precisa ser suportado
+std::size_t overlapCircles(glm::vec2 center, float radius,
+                           const glm::vec2 *centers, const float *scales,
+                           float scaleFactor, std::size_t count,
+                           std::uint64_t *hits, SimdPath path = bestSimdPath());
+
+#endif
@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "overlapkernel.hpp"
+#include "simulation.hpp"
+#include "spatialgrid.hpp"
+
+namespace {
+// Mascara esperada pela regra de colisao do jogo (escala do gato * 0.9 +
+// escala do asteroide * 0.85), testando circulo a circulo
+std::vector<std::uint64_t> expectedHits(glm::vec2 center, float radius,
+                                        const std::vector<glm::vec2> &centers,
+                                        const std::vector<float> &scales) {
+  std::vector<std::uint64_t> expected(overlapMaskWords(centers.size()));
+  for (std::size_t i{0}; i < centers.size(); ++i) {
+    const auto offset{centers[i] - center};
+    const auto distance{radius + scales[i] * 0.85f};
+    if (offset.x * offset.x + offset.y * offset.y < distance * distance) {
+      expected[i / 64] |= std::uint64_t{1} << (i % 64);
+    }
+  }
+  return expected;
+}
+
+std::size_t countHits(const std::vector<std::uint64_t> &mask) {
+  std::size_t total{0};
+  for (const auto word : mask) {
+    total += static_cast<std::size_t>(__builtin_popcountll(word));
+  }
+  return total;
+}
+
+// Compara cada caminho do kernel com a regra de colisao em campos aleatorios
+// de varios tamanhos, inclusive os que nao completam um vetor
+bool verifyOverlapKernel() {
+  std::default_random_engine re{3};
+  std::uniform_real_distribution<float> randomPosition{-1.0f, 1.0f};
+  std::uniform_real_distribution<float> randomScale{0.05f, 0.5f};
+
+  bool ok{true};
+  for (const std::size_t count : {0, 1, 3, 4, 7, 8, 9, 63, 64, 65, 1000}) {
+    std::vector<glm::vec2> centers(count);
+    std::vector<float> scales(count);
+    for (std::size_t i{0}; i < count; ++i) {
+      centers[i] = glm::vec2{randomPosition(re), randomPosition(re)};
+      scales[i] = randomScale(re);
+    }
+    CatState cat;
+    cat.m_translation = glm::vec2{randomPosition(re), randomPosition(re)};
+
+    const auto radius{cat.m_scale * 0.9f};
+    const auto expected{expectedHits(cat.m_translation, radius, centers,
+                                     scales)};
+    const auto expectedTotal{countHits(expected)};
+
+    for (const auto path : {SimdPath::Scalar, SimdPath::Sse2, SimdPath::Avx2}) {
+      if (!simdPathSupported(path)) continue;
+      std::vector<std::uint64_t> hits(overlapMaskWords(count), ~0ull);
+      const auto total{overlapCircles(cat.m_translation, radius,
+                                      centers.data(), scales.data(), 0.85f,
+                                      count, hits.data(), path)};
+      if (hits != expected || total != expectedTotal) {
+        std::fprintf(stderr, "overlapCircles/%s: wrong mask for %zu circles\n",
+                     simdPathName(path), count);
+        ok = false;
+      }
+    }
+  }
+  return ok;
+}
+
+// Caminho do checkCollisions: candidatos da grade e kernel sobre eles devem
+// achar as mesmas colisoes que o kernel sobre o campo inteiro, inclusive
+// com circulos fora dos limites da grade (presos nas celulas da borda)
+bool verifyGridCandidates() {
+  std::default_random_engine re{5};
+  std::uniform_real_distribution<float> randomPosition{-1.4f, 1.4f};
+  std::uniform_real_distribution<float> randomScale{0.05f, 0.5f};
+
+  constexpr std::size_t count{500};
+  std::vector<glm::vec2> centers(count);
+  std::vector<float> scales(count);
+  SpatialGrid grid;
+  grid.initialize(glm::vec2{-1.0f}, glm::vec2{1.0f}, 0.25f);
+  for (std::size_t i{0}; i < count; ++i) {
+    centers[i] = glm::vec2{randomPosition(re), randomPosition(re)};
+    scales[i] = randomScale(re);
+    grid.insert(static_cast<std::uint32_t>(i), centers[i], scales[i] * 0.85f);
+  }
+
+  std::vector<std::uint32_t> candidates;
+  std::vector<glm::vec2> candidateCenters;
+  std::vector<float> candidateRadii;
+  for (int query{0}; query < 200; ++query) {
+    const glm::vec2 center{randomPosition(re), randomPosition(re)};
+    const auto radius{0.125f * 0.9f};
+
+    grid.candidates(center, radius, candidates, candidateCenters,
+                    candidateRadii);
+    std::vector<std::uint64_t> hits(overlapMaskWords(candidates.size()));
+    overlapCircles(center, radius, candidateCenters.data(),
+                   candidateRadii.data(), 1.0f, candidates.size(),
+                   hits.data());
+
+    std::vector<std::uint32_t> found;
+    for (std::size_t i{0}; i < candidates.size(); ++i) {
+      if ((hits[i / 64] >> (i % 64) & 1) != 0) found.push_back(candidates[i]);
+    }
+    std::sort(found.begin(), found.end());
+
+    const auto expected{expectedHits(center, radius, centers, scales)};
+    std::vector<std::uint32_t> wanted;
+    for (std::size_t i{0}; i < count; ++i) {
+      if ((expected[i / 64] >> (i % 64) & 1) != 0) {
+        wanted.push_back(static_cast<std::uint32_t>(i));
+      }
+    }
+
+    if (found != wanted) {
+      std::fprintf(stderr,
+                   "SpatialGrid::candidates: %zu hits, expected %zu at "
+                   "(%.3f, %.3f)\n",
+                   found.size(), wanted.size(), center.x, center.y);
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+// Teste do kernel de sobreposicao (ctest). Sai com codigo 1 se algum caminho
+// suportado pela CPU ou a consulta pela grade divergir da regra de colisao
+int main() {
+  const auto kernelOk{verifyOverlapKernel()};
+  const auto gridOk{verifyGridCandidates()};
+  std::printf("overlap kernel (%s): %s\n", simdPathName(bestSimdPath()),
+              kernelOk && gridOk ? "ok" : "FAILED");
+  return kernelOk && gridOk ? 0 : 1;
+}
@@ -0,0 +1,225 @@
+#include "profiler.hpp"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "allocationcounter.hpp"
+#include "glresource.hpp"
+
+namespace {
+constexpr std::array<const char *, 6> sectionNames{
+    "Update", "StarLayers", "Clouds", "Asteroids", "Cat", "UI"};
+
+// Secoes que nao emitem comandos GL e por isso nao usam timer query
+bool cpuOnly(FrameProfiler::Section section) {
+  return section == FrameProfiler::Section::Update ||
+         section == FrameProfiler::Section::UI;
+}
+}  // namespace
+
+void FrameProfiler::History::push(float value) {
+  m_values[m_next] = value;
+  m_next = (m_next + 1) % m_values.size();
+  m_size = std::min(m_size + 1, m_values.size());
+}
+
+float FrameProfiler::History::average() const {
+  if (m_size == 0) return 0.0f;
+  float sum{0.0f};
+  for (std::size_t i{0}; i < m_size; ++i) {
+    sum += m_values[i];
+  }
+  return sum / static_cast<float>(m_size);
+}
+
+float FrameProfiler::History::latest() const {
+  if (m_size == 0) return 0.0f;
+  return m_values[(m_next + m_values.size() - 1) % m_values.size()];
+}
+
+void FrameProfiler::initializeGL() {
+  terminateGL();
+
+#if !defined(__EMSCRIPTEN__)
+  // GL_TIME_ELAPSED nao existe no WebGL/OpenGL ES
+  for (auto &queries : m_queries) {
+    abcg::glGenQueries(static_cast<GLsizei>(queries.size()), queries.data());
+  }
+  m_timerQueries = true;
+#endif
+
+  m_frameStart = Clock::now();
+}
+
+void FrameProfiler::terminateGL() {
+  if (m_timerQueries) {
+    for (auto &queries : m_queries) {
+      abcg::glDeleteQueries(static_cast<GLsizei>(queries.size()),
+                            queries.data());
+      queries.fill(0);
+    }
+  }
+  for (auto &pending : m_pending) {
+    pending.fill(false);
+  }
+  m_timerQueries = false;
+}
+
+void FrameProfiler::beginFrame() {
+  const auto now{Clock::now()};
+  m_frameTimes.push(
+      std::chrono::duration<float, std::milli>{now - m_frameStart}.count());
+  m_frameStart = now;
+
+  const auto allocations{AllocationCounter::count()};
+  m_lastAllocations = allocations - m_allocationsAtFrameStart;
+  m_allocationsAtFrameStart = allocations;
+
+  m_lastDrawCalls = m_drawCalls;
+  m_lastVertices = m_vertices;
+  m_lastStateCallsIssued = m_stateCallsIssued;
+  m_lastStateCallsSkipped = m_stateCallsSkipped;
+  m_drawCalls = 0;
+  m_vertices = 0;
+  m_stateCallsIssued = 0;
+  m_stateCallsSkipped = 0;
+  m_gpuTimingRequired = false;
+
+  // O conjunto deste quadro foi usado dois quadros atras
+  ++m_frame;
+  readQueries(m_frame % 2);
+}
+
+void FrameProfiler::resetHistory() {
+  for (auto &history : m_cpu) history = History{};
+  for (auto &history : m_gpu) history = History{};
+  m_frameTimes = History{};
+}
+
+float FrameProfiler::gpuSceneTime() const {
+  float total{0.0f};
+  for (std::size_t index{0}; index < m_sectionCount; ++index) {
+    if (!cpuOnly(static_cast<Section>(index))) total += m_gpu[index].latest();
+  }
+  return total;
+}
+
+void FrameProfiler::begin(Section section) {
+  const auto index{static_cast<std::size_t>(section)};
+  m_cpuStart[index] = Clock::now();
+
+#if !defined(__EMSCRIPTEN__)
+  if (gpuTimingActive() && m_timerQueries && !cpuOnly(section)) {
+    const auto set{m_frame % 2};
+    abcg::glBeginQuery(GL_TIME_ELAPSED, m_queries[set][index]);
+  }
+#endif
+}
+
+void FrameProfiler::end(Section section) {
+  const auto index{static_cast<std::size_t>(section)};
+  if (m_synchronous && !cpuOnly(section)) abcg::glFinish();
+
+#if !defined(__EMSCRIPTEN__)
+  if (gpuTimingActive() && m_timerQueries && !cpuOnly(section)) {
+    abcg::glEndQuery(GL_TIME_ELAPSED);
+    m_pending[m_frame % 2][index] = true;
+  }
+#endif
+
+  m_cpu[index].push(std::chrono::duration<float, std::milli>{
+      Clock::now() - m_cpuStart[index]}.count());
+}
+
+// Le apenas os resultados ja disponiveis; os outros sao descartados
+void FrameProfiler::readQueries([[maybe_unused]] std::size_t set) {
+#if !defined(__EMSCRIPTEN__)
+  for (std::size_t index{0}; index < m_sectionCount; ++index) {
+    if (!m_pending[set][index]) continue;
+    m_pending[set][index] = false;
+
+    GLuint available{GL_FALSE};
+    abcg::glGetQueryObjectuiv(m_queries[set][index],
+                              GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available == GL_FALSE) continue;
+
+    GLuint64 elapsed{};
+    abcg::glGetQueryObjectui64v(m_queries[set][index], GL_QUERY_RESULT,
+                                &elapsed);
+    m_gpu[index].push(static_cast<float>(elapsed) * 1e-6f);
+  }
+#endif
+}
+
+float FrameProfiler::percentile(float fraction,
+                                std::pmr::memory_resource &scratch) const {
+  if (m_frameTimes.m_size == 0) return 0.0f;
+
+  const auto first{m_frameTimes.m_values.begin()};
+  std::pmr::vector<float> sorted(
+      first, first + static_cast<std::ptrdiff_t>(m_frameTimes.m_size),
+      &scratch);
+  const auto nth{static_cast<std::size_t>(
+      fraction * static_cast<float>(sorted.size() - 1))};
+  std::nth_element(sorted.begin(),
+                   sorted.begin() + static_cast<std::ptrdiff_t>(nth),
+                   sorted.end());
+  return sorted[nth];
+}
+
+void FrameProfiler::paintUI(std::pmr::memory_resource &scratch) {
+  if (!m_visible) return;
+
+  ImGui::SetNextWindowPos(ImVec2(5, 150), ImGuiCond_FirstUseEver);
+  ImGui::SetNextWindowSize(ImVec2(330, 300), ImGuiCond_FirstUseEver);
+  ImGui::Begin("Profiler (F3)", &m_visible);
+
+  ImGui::Columns(3);
+  ImGui::Text("Secao");
+  ImGui::NextColumn();
+  ImGui::Text("CPU (ms)");
+  ImGui::NextColumn();
+  ImGui::Text("GPU (ms)");
+  ImGui::NextColumn();
+  ImGui::Separator();
+  for (std::size_t index{0}; index < m_sectionCount; ++index) {
+    ImGui::Text("%s", sectionNames.at(index));
+    ImGui::NextColumn();
+    ImGui::Text("%.3f", m_cpu[index].average());
+    ImGui::NextColumn();
+    if (m_timerQueries && !cpuOnly(static_cast<Section>(index))) {
+      ImGui::Text("%.3f", m_gpu[index].average());
+    } else {
+      ImGui::Text("-");
+    }
+    ImGui::NextColumn();
+  }
+  ImGui::Columns(1);
+  ImGui::Separator();
+
+  ImGui::Text("Draw calls: %ld  Vertices: %ld", m_lastDrawCalls,
+              m_lastVertices);
+  ImGui::Text("GL state calls: %ld issued, %ld skipped",
+              m_lastStateCallsIssued, m_lastStateCallsSkipped);
+
+  // Grafico do tempo de quadro, do mais antigo para o mais recente
+  ImGui::PlotLines("##frametime", m_frameTimes.m_values.data(),
+                   static_cast<int>(m_frameTimes.m_size),
+                   m_frameTimes.m_size < m_historySize
+                       ? 0
+                       : static_cast<int>(m_frameTimes.m_next),
+                   "Frame time (ms)", 0.0f, 50.0f, ImVec2(-1, 80));
+  ImGui::Text("p50 %.2f  p95 %.2f  p99 %.2f ms", percentile(0.50f, scratch),
+              percentile(0.95f, scratch), percentile(0.99f, scratch));
+  if (AllocationCounter::enabled()) {
+    ImGui::Text("Heap allocs/quadro: %llu",
+                static_cast<unsigned long long>(m_lastAllocations));
+  }
+  if (ImGui::CollapsingHeader("Objetos OpenGL")) {
+    GLResourceRegistry::paintUI();
+  }
+
+  ImGui::End();
+}
@@ -0,0 +1,132 @@
+#ifndef PROFILER_HPP_
+#define PROFILER_HPP_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+#include "abcg.hpp"
+
+// Perfilador de quadro: tempos de CPU por subsistema (media movel), tempos de
+// GPU com queries GL_TIME_ELAPSED, numero de draw calls/vertices e um grafico
+// do tempo de quadro com percentis. As queries usam dois conjuntos
+// alternados: o resultado de um quadro so e lido dois quadros depois, e
+// apenas se ja estiver disponivel, entao a leitura nunca bloqueia
+class FrameProfiler {
+ public:
+  enum class Section { Update, Stars, Clouds, Asteroids, Cat, UI, Count };
+
+  void initializeGL();
+  // scratch: memoria temporaria do quadro (ex.: FrameArena)
+  void paintUI(std::pmr::memory_resource &scratch);
+  void terminateGL();
+
+  void beginFrame();
+  void begin(Section section);
+  void end(Section section);
+
+  // Chamado pelos renderizadores a cada draw call
+  static void countDraw(long vertices, long instances = 1) {
+    ++m_drawCalls;
+    m_vertices += vertices * instances;
+  }
+  // Chamado pelo GLStateCache: chamadas de estado emitidas e evitadas
+  static void countStateCall(bool issued) {
+    ++(issued ? m_stateCallsIssued : m_stateCallsSkipped);
+  }
+
+  // Media do tempo de CPU da secao (ms) e descarte do historico
+  [[nodiscard]] float cpuAverage(Section section) const {
+    return m_cpu[static_cast<std::size_t>(section)].average();
+  }
+  void resetHistory();
+
+  // Soma dos ultimos tempos de GPU lidos dos passes da cena (ms); 0 sem
+  // timer queries
+  [[nodiscard]] float gpuSceneTime() const;
+
+  bool m_visible{false};
+  // Espera a GPU terminar (glFinish) no fim de cada secao, para que o tempo
+  // de CPU inclua o custo inteiro do desenho (ex.: GL por software)
+  bool m_synchronous{false};
+  // Mantem as queries de GPU ativas com o painel escondido
+  bool m_gpuTiming{false};
+
+  // Pede as queries de GPU so para o quadro atual (depois do beginFrame),
+  // sem mexer em m_gpuTiming. Usado pela qualidade adaptativa
+  void requireGpuTiming() { m_gpuTimingRequired = true; }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  bool m_gpuTimingRequired{false};
+  [[nodiscard]] bool gpuTimingActive() const {
+    return m_visible || m_gpuTiming || m_gpuTimingRequired;
+  }
+
+  static constexpr std::size_t m_sectionCount{
+      static_cast<std::size_t>(Section::Count)};
+  static constexpr std::size_t m_historySize{240};
+
+  // Historico circular em milissegundos
+  struct History {
+    std::array<float, m_historySize> m_values{};
+    std::size_t m_next{};
+    std::size_t m_size{};
+
+    void push(float value);
+    [[nodiscard]] float average() const;
+    [[nodiscard]] float latest() const;
+  };
+
+  std::array<History, m_sectionCount> m_cpu;
+  std::array<History, m_sectionCount> m_gpu;
+  History m_frameTimes;
+
+  std::array<Clock::time_point, m_sectionCount> m_cpuStart;
+  Clock::time_point m_frameStart;
+
+  // Dois conjuntos de queries, alternados a cada quadro
+  bool m_timerQueries{false};
+  std::array<std::array<GLuint, m_sectionCount>, 2> m_queries{};
+  std::array<std::array<bool, m_sectionCount>, 2> m_pending{};
+  std::size_t m_frame{};
+
+  inline static long m_drawCalls{};
+  inline static long m_vertices{};
+  inline static long m_stateCallsIssued{};
+  inline static long m_stateCallsSkipped{};
+  long m_lastDrawCalls{};
+  long m_lastVertices{};
+  long m_lastStateCallsIssued{};
+  long m_lastStateCallsSkipped{};
+
+  // Alocacoes no heap do ultimo quadro (apenas em builds de depuracao)
+  std::uint64_t m_allocationsAtFrameStart{};
+  std::uint64_t m_lastAllocations{};
+
+  void readQueries(std::size_t set);
+  [[nodiscard]] float percentile(float fraction,
+                                 std::pmr::memory_resource &scratch) const;
+};
+
+// Mede o trecho (CPU e GPU) entre a construcao e a destruicao
+class ProfileScope {
+ public:
+  ProfileScope(FrameProfiler &profiler, FrameProfiler::Section section)
+      : m_profiler{profiler}, m_section{section} {
+    m_profiler.begin(m_section);
+  }
+  ~ProfileScope() { m_profiler.end(m_section); }
+
+  ProfileScope(const ProfileScope &) = delete;
+  ProfileScope &operator=(const ProfileScope &) = delete;
+
+ private:
+  FrameProfiler &m_profiler;
+  FrameProfiler::Section m_section;
+};
+
+#endif
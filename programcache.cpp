@@ -0,0 +1,221 @@
+#include "programcache.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+namespace {
+std::string readFile(const std::string &path) {
+  std::ifstream file{path, std::ios::binary};
+  if (!file) {
+    throw abcg::Exception{abcg::Exception::Runtime(
+        fmt::format("Cannot read shader file {}", path))};
+  }
+  return std::string{std::istreambuf_iterator<char>{file},
+                     std::istreambuf_iterator<char>{}};
+}
+
+// Insere as definicoes logo depois da linha #version
+std::string applyDefines(std::string source,
+                         const std::vector<std::string> &defines) {
+#if defined(__EMSCRIPTEN__)
+  const std::string desktopVersion{"#version 410"};
+  if (const auto position{source.find(desktopVersion)};
+      position != std::string::npos) {
+    source.replace(position, desktopVersion.size(),
+                   "#version 300 es\nprecision mediump float;");
+  }
+#endif
+
+  std::string header;
+  for (const auto &define : defines) {
+    header += "#define " + define + "\n";
+  }
+
+  const auto version{source.find("#version")};
+  const auto lineEnd{version == std::string::npos
+                         ? std::string::npos
+                         : source.find('\n', version)};
+  if (lineEnd == std::string::npos) return header + source;
+  return source.insert(lineEnd + 1, header);
+}
+
+// FNV-1a de 64 bits
+std::uint64_t hashString(std::uint64_t hash, const std::string &value) {
+  for (const auto c : value) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+std::string glString(GLenum name) {
+  const auto *value{abcg::glGetString(name)};
+  return value != nullptr ? reinterpret_cast<const char *>(value) : "";
+}
+
+void checkShader(GLuint shader) {
+  GLint status{};
+  abcg::glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+  if (status == GL_FALSE) {
+    GLint length{};
+    abcg::glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+    std::string log(static_cast<std::size_t>(std::max(length, 1)), '\0');
+    abcg::glGetShaderInfoLog(shader, length, nullptr, log.data());
+    throw abcg::Exception{abcg::Exception::Runtime(
+        fmt::format("Failed to compile shader: {}", log))};
+  }
+}
+}  // namespace
+
+void ProgramCache::initialize(std::string directory) {
+  m_directory = std::move(directory);
+  m_driver = glString(GL_VENDOR) + "|" + glString(GL_RENDERER) + "|" +
+             glString(GL_VERSION);
+  m_hits = 0;
+  m_misses = 0;
+
+  m_binariesSupported = false;
+#if !defined(__EMSCRIPTEN__)
+  GLint formats{};
+  abcg::glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+  std::error_code error;
+  std::filesystem::create_directories(m_directory, error);
+  m_binariesSupported = formats > 0 && !error;
+#endif
+}
+
+GLuint ProgramCache::load(const std::string &vertexPath,
+                          const std::string &fragmentPath,
+                          const std::vector<std::string> &defines) {
+  const auto vertexSource{applyDefines(readFile(vertexPath), defines)};
+  const auto fragmentSource{applyDefines(readFile(fragmentPath), defines)};
+
+  std::string path;
+  if (m_binariesSupported) {
+    auto key{hashString(14695981039346656037ull, vertexSource)};
+    key = hashString(key, fragmentSource);
+    key = hashString(key, m_driver);
+    path = (std::filesystem::path{m_directory} /
+            fmt::format("{:016x}.bin", key))
+               .string();
+
+    if (const auto program{loadBinary(path)}; program != 0) {
+      ++m_hits;
+      return program;
+    }
+  }
+
+  ++m_misses;
+  const auto program{compile(vertexSource, fragmentSource, !path.empty())};
+  if (!path.empty()) saveBinary(program, path);
+  return program;
+}
+
+// Formato do arquivo: GLenum do formato binario seguido do binario
+GLuint ProgramCache::loadBinary(
+    [[maybe_unused]] const std::string &path) const {
+#if !defined(__EMSCRIPTEN__)
+  std::ifstream file{path, std::ios::binary};
+  if (!file) return 0;
+
+  GLenum format{};
+  file.read(reinterpret_cast<char *>(&format), sizeof(format));
+  std::vector<char> binary{std::istreambuf_iterator<char>{file},
+                           std::istreambuf_iterator<char>{}};
+  if (!file.eof() || binary.empty()) return 0;
+
+  const auto program{abcg::glCreateProgram()};
+  abcg::glProgramBinary(program, format, binary.data(),
+                        static_cast<GLsizei>(binary.size()));
+
+  GLint status{};
+  abcg::glGetProgramiv(program, GL_LINK_STATUS, &status);
+  if (status == GL_FALSE) {
+    abcg::glDeleteProgram(program);
+    return 0;
+  }
+  return program;
+#else
+  return 0;
+#endif
+}
+
+void ProgramCache::saveBinary([[maybe_unused]] GLuint program,
+                              [[maybe_unused]] const std::string &path) const {
+#if !defined(__EMSCRIPTEN__)
+  GLint length{};
+  abcg::glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0) return;
+
+  GLenum format{};
+  std::vector<char> binary(static_cast<std::size_t>(length));
+  abcg::glGetProgramBinary(program, length, nullptr, &format, binary.data());
+
+  // Falhas ao escrever apenas deixam o programa fora do cache
+  std::ofstream file{path, std::ios::binary};
+  file.write(reinterpret_cast<const char *>(&format), sizeof(format));
+  file.write(binary.data(), static_cast<std::streamsize>(binary.size()));
+#endif
+}
+
+GLuint ProgramCache::compile(const std::string &vertexSource,
+                             const std::string &fragmentSource,
+                             [[maybe_unused]] bool retrievable) {
+  const std::array<std::pair<GLenum, const std::string *>, 2> stages{
+      {{GL_VERTEX_SHADER, &vertexSource},
+       {GL_FRAGMENT_SHADER, &fragmentSource}}};
+
+  const auto program{abcg::glCreateProgram()};
+  std::array<GLuint, 2> shaders{};
+  try {
+    for (std::size_t index{0}; index < stages.size(); ++index) {
+      const auto *source{stages[index].second->c_str()};
+      shaders[index] = abcg::glCreateShader(stages[index].first);
+      abcg::glShaderSource(shaders[index], 1, &source, nullptr);
+      abcg::glCompileShader(shaders[index]);
+      checkShader(shaders[index]);
+      abcg::glAttachShader(program, shaders[index]);
+    }
+  } catch (...) {
+    // Erro de compilacao: libera os shaders ja criados e o programa (que
+    // desanexa os shaders ao ser excluido) antes de propagar
+    for (const auto shader : shaders) {
+      if (shader != 0) abcg::glDeleteShader(shader);
+    }
+    abcg::glDeleteProgram(program);
+    throw;
+  }
+
+#if !defined(__EMSCRIPTEN__)
+  if (retrievable) {
+    abcg::glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                              GL_TRUE);
+  }
+#endif
+  abcg::glLinkProgram(program);
+
+  for (const auto shader : shaders) {
+    abcg::glDetachShader(program, shader);
+    abcg::glDeleteShader(shader);
+  }
+
+  GLint status{};
+  abcg::glGetProgramiv(program, GL_LINK_STATUS, &status);
+  if (status == GL_FALSE) {
+    GLint length{};
+    abcg::glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+    std::string log(static_cast<std::size_t>(std::max(length, 1)), '\0');
+    abcg::glGetProgramInfoLog(program, length, nullptr, log.data());
+    abcg::glDeleteProgram(program);
+    throw abcg::Exception{abcg::Exception::Runtime(
+        fmt::format("Failed to link program: {}", log))};
+  }
+
+  return program;
+}
@@ -0,0 +1,44 @@
+#ifndef PROGRAMCACHE_HPP_
+#define PROGRAMCACHE_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "abcg.hpp"
+
+// Cache de programas GLSL ja ligados. O binario de glGetProgramBinary e
+// salvo em disco com uma chave formada pelo hash dos fontes, das definicoes
+// do variante e das strings de fabricante/renderizador/versao do driver. Nas
+// proximas execucoes o programa e carregado com glProgramBinary; se o
+// carregamento falhar (driver atualizado, arquivo corrompido), o programa e
+// compilado de novo e o cache e reescrito.
+//
+// Variantes: as definicoes passadas em load() sao inseridas logo depois da
+// linha #version, entao um mesmo fonte gera, p. ex., o shader de objetos
+// com uniforms e o instanciado (INSTANCED)
+class ProgramCache {
+ public:
+  void initialize(std::string directory);
+
+  GLuint load(const std::string &vertexPath, const std::string &fragmentPath,
+              const std::vector<std::string> &defines = {});
+
+  // Quantos programas vieram do cache e quantos foram compilados
+  [[nodiscard]] int hits() const { return m_hits; }
+  [[nodiscard]] int misses() const { return m_misses; }
+
+ private:
+  std::string m_directory;
+  std::string m_driver;
+  bool m_binariesSupported{false};
+  int m_hits{};
+  int m_misses{};
+
+  GLuint loadBinary(const std::string &path) const;
+  void saveBinary(GLuint program, const std::string &path) const;
+  static GLuint compile(const std::string &vertexSource,
+                        const std::string &fragmentSource, bool retrievable);
+};
+
+#endif
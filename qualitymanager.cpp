@@ -0,0 +1,77 @@
+#include "qualitymanager.hpp"
+
+#include <imgui.h>
+
+#include <algorithm>
+
+bool QualityManager::update(float frameTime, int targetFps) {
+  m_budget = 1000.0f / static_cast<float>(targetFps > 0 ? targetFps : 60);
+  m_windowSum += frameTime;
+  if (++m_windowFrames < m_windowSize) return false;
+
+  m_lastAverage = m_windowSum / static_cast<float>(m_windowFrames);
+  m_windowSum = 0.0f;
+  m_windowFrames = 0;
+  m_windowsAtLevel = std::min(m_windowsAtLevel + 1, m_maxRaiseWindows);
+  if (!m_adaptive) return false;
+
+  const auto load{m_lastAverage / m_budget};
+  m_overWindows = load > m_dropThreshold ? m_overWindows + 1 : 0;
+  m_underWindows = load < m_raiseThreshold ? m_underWindows + 1 : 0;
+
+  const auto last{static_cast<int>(m_levels.size()) - 1};
+  if (m_overWindows >= m_dropWindows && m_level < last) {
+    // A subida anterior nao se sustentou: espera mais antes da proxima
+    if (m_raised && m_windowsAtLevel < m_maxRaiseWindows) {
+      m_raiseWindows = std::min(m_raiseWindows * 2, m_maxRaiseWindows);
+    }
+    setLevel(m_level + 1);
+    m_raised = false;
+    return true;
+  }
+  if (m_underWindows >= m_raiseWindows && m_level > 0) {
+    setLevel(m_level - 1);
+    m_raised = true;
+    return true;
+  }
+  // A subida se sustentou: volta a reagir rapido
+  if (m_raised && m_windowsAtLevel >= m_maxRaiseWindows) {
+    m_raiseWindows = m_minRaiseWindows;
+  }
+  return false;
+}
+
+// A janela seguinte a troca ainda mistura quadros dos dois niveis
+void QualityManager::setLevel(int level) {
+  m_level = level;
+  m_windowsAtLevel = 0;
+  m_overWindows = 0;
+  m_underWindows = 0;
+  m_windowSum = 0.0f;
+  m_windowFrames = 0;
+}
+
+void QualityManager::paintUI() {
+  if (!m_visible) return;
+
+  ImGui::SetNextWindowPos(ImVec2(340, 380), ImGuiCond_FirstUseEver);
+  ImGui::SetNextWindowSize(ImVec2(255, 190), ImGuiCond_FirstUseEver);
+  ImGui::Begin("Qualidade (F8)", &m_visible);
+
+  ImGui::Checkbox("Adaptativa", &m_adaptive);
+  auto level{m_level};
+  if (ImGui::SliderInt("Nivel", &level, 0,
+                       static_cast<int>(m_levels.size()) - 1,
+                       m_levels[level].m_name)) {
+    setLevel(level);
+  }
+  ImGui::Separator();
+
+  const auto &current{m_levels[m_level]};
+  ImGui::Text("Resolucao: %.0f%%", current.m_resolutionScale * 100.0f);
+  ImGui::Text("MSAA: %dx", current.m_samples);
+  ImGui::Text("Estrelas: %d por camada", current.m_starDensity);
+  ImGui::Text("Custo: %.2f / %.2f ms", m_lastAverage, m_budget);
+
+  ImGui::End();
+}
@@ -0,0 +1,69 @@
+#ifndef QUALITYMANAGER_HPP_
+#define QUALITYMANAGER_HPP_
+
+#include <array>
+#include <cstddef>
+
+struct QualityLevel {
+  const char *m_name;
+  // Fracao da resolucao da janela usada pela cena
+  float m_resolutionScale;
+  int m_samples;
+  // Estrelas da primeira camada (ver StarLayers)
+  int m_starDensity;
+};
+
+// Qualidade adaptativa: compara o custo medio dos quadros com o orcamento
+// (1 / FPS alvo) e troca de nivel com histerese. Cai um nivel depois de
+// m_dropWindows janelas seguidas acima de m_dropThreshold do orcamento e
+// sobe depois de m_raiseWindows janelas abaixo de m_raiseThreshold. Cada
+// queda logo apos uma subida dobra a espera para subir de novo, para o
+// nivel nao oscilar entre dois vizinhos
+class QualityManager {
+ public:
+  static constexpr std::array<QualityLevel, 5> m_levels{{
+      {"Alta", 1.0f, 4, 25},
+      {"Media", 1.0f, 2, 20},
+      {"Baixa", 0.85f, 0, 15},
+      {"Muito baixa", 0.7f, 0, 10},
+      {"Minima", 0.5f, 0, 5},
+  }};
+
+  // Registra o custo do quadro (ms); retorna true se o nivel mudou
+  bool update(float frameTime, int targetFps);
+
+  [[nodiscard]] const QualityLevel &level() const { return m_levels[m_level]; }
+
+  void paintUI();
+
+  bool m_visible{false};
+  bool m_adaptive{true};
+
+ private:
+  static constexpr std::size_t m_windowSize{30};
+  static constexpr float m_dropThreshold{0.9f};
+  static constexpr float m_raiseThreshold{0.6f};
+  static constexpr int m_dropWindows{2};
+  static constexpr int m_minRaiseWindows{8};
+  static constexpr int m_maxRaiseWindows{64};
+
+  int m_level{0};
+
+  // Janela atual e ultima media fechada
+  float m_windowSum{};
+  std::size_t m_windowFrames{};
+  float m_lastAverage{};
+  float m_budget{};
+
+  int m_overWindows{};
+  int m_underWindows{};
+  int m_raiseWindows{m_minRaiseWindows};
+  // Janelas no nivel atual e se ele foi alcancado subindo (para detectar
+  // oscilacao)
+  int m_windowsAtLevel{};
+  bool m_raised{false};
+
+  void setLevel(int level);
+};
+
+#endif
@@ -0,0 +1,118 @@
+#include "renderqueue.hpp"
+
+#include <algorithm>
+
+namespace {
+constexpr std::uint64_t key(RenderQueue::Layer layer, BlendMode blend,
+                            GLuint program, GLuint vao,
+                            std::uint64_t sequence) {
+  return static_cast<std::uint64_t>(layer) << 56 |
+         static_cast<std::uint64_t>(blend) << 54 |
+         static_cast<std::uint64_t>(program & 0xffff) << 38 |
+         static_cast<std::uint64_t>(vao & 0xffff) << 22 |
+         (sequence & 0x3fffff);
+}
+}  // namespace
+
+DrawPacket &RenderQueue::submit(Layer layer, GLuint program, GLuint vao,
+                                BlendMode blend) {
+  auto &packet{m_packets.emplace_back()};
+  packet.m_key = key(layer, blend, program, vao, m_packets.size() - 1);
+  packet.m_program = program;
+  packet.m_vao = vao;
+  packet.m_blend = blend;
+  packet.m_firstUniform = static_cast<std::uint32_t>(m_uniforms.size());
+  return packet;
+}
+
+void RenderQueue::uniform(GLint location, float value) {
+  addUniform(location, 1, {value});
+}
+
+void RenderQueue::uniform(GLint location, glm::vec2 value) {
+  addUniform(location, 2, {value.x, value.y});
+}
+
+void RenderQueue::uniform(GLint location, glm::vec4 value) {
+  addUniform(location, 4, {value.r, value.g, value.b, value.a});
+}
+
+void RenderQueue::addUniform(GLint location, GLint components,
+                             std::array<float, 4> values) {
+  m_uniforms.push_back(Uniform{location, components, values});
+  ++m_packets.back().m_uniformCount;
+}
+
+void RenderQueue::execute(FrameProfiler &profiler) {
+  std::sort(m_packets.begin(), m_packets.end(),
+            [](const auto &a, const auto &b) { return a.m_key < b.m_key; });
+
+  // Os binds podem ter sido mudados fora da fila desde o ultimo quadro
+  m_state.invalidate();
+
+  bool measuring{false};
+  Layer layer{};
+
+  for (const auto &packet : m_packets) {
+    const auto packetLayer{static_cast<Layer>(packet.m_key >> 56)};
+    if (!measuring || packetLayer != layer) {
+      if (measuring) profiler.end(layer);
+      layer = packetLayer;
+      profiler.begin(layer);
+      measuring = true;
+    }
+
+    m_state.setBlend(packet.m_blend);
+    m_state.useProgram(packet.m_program);
+    m_state.bindVertexArray(packet.m_vao);
+
+    for (auto index{packet.m_firstUniform};
+         index < packet.m_firstUniform + packet.m_uniformCount; ++index) {
+      const auto &uniform{m_uniforms[index]};
+      m_state.uniform(uniform.m_location, uniform.m_components,
+                      uniform.m_values.data());
+    }
+
+    draw(packet);
+  }
+  if (measuring) profiler.end(layer);
+
+  // Programa e blend podem ficar como estao; so o VAO e desligado, para que
+  // um bind de GL_ELEMENT_ARRAY_BUFFER fora da fila nao altere o ultimo VAO
+  m_state.bindVertexArray(0);
+
+  m_packets.clear();
+  m_uniforms.clear();
+}
+
+void RenderQueue::draw(const DrawPacket &packet) {
+  if (const auto *layout{packet.m_instanceLayout}) {
+    m_state.bindArrayBuffer(packet.m_instanceBuffer);
+    for (const auto &attribute : layout->m_attributes) {
+      abcg::glVertexAttribPointer(
+          attribute.m_index, attribute.m_size, GL_FLOAT, GL_FALSE,
+          layout->m_stride,
+          reinterpret_cast<void *>(packet.m_instanceOffset +
+                                   attribute.m_offset));
+    }
+  }
+
+  if (packet.m_indexed) {
+    const auto *first{reinterpret_cast<void *>(
+        static_cast<std::uintptr_t>(packet.m_first) * sizeof(GLuint))};
+    if (packet.m_instances > 1) {
+      abcg::glDrawElementsInstanced(packet.m_mode, packet.m_count,
+                                    GL_UNSIGNED_INT, first,
+                                    packet.m_instances);
+    } else {
+      abcg::glDrawElements(packet.m_mode, packet.m_count, GL_UNSIGNED_INT,
+                           first);
+    }
+  } else if (packet.m_instanceLayout != nullptr || packet.m_instances > 1) {
+    abcg::glDrawArraysInstanced(packet.m_mode, packet.m_first, packet.m_count,
+                                packet.m_instances);
+  } else {
+    abcg::glDrawArrays(packet.m_mode, packet.m_first, packet.m_count);
+  }
+  FrameProfiler::countDraw(packet.m_count, packet.m_instances);
+}
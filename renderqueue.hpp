@@ -0,0 +1,89 @@
+#ifndef RENDERQUEUE_HPP_
+#define RENDERQUEUE_HPP_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "abcg.hpp"
+#include "glstatecache.hpp"
+#include "profiler.hpp"
+
+// Atributos por instancia (float) lidos de um buffer a partir de um
+// deslocamento, definido por pacote. Substitui o glDraw*BaseInstance, que
+// nao existe no OpenGL 4.1
+struct InstanceLayout {
+  struct Attribute {
+    GLuint m_index{};
+    GLint m_size{};
+    GLintptr m_offset{};
+  };
+
+  GLsizei m_stride{};
+  std::vector<Attribute> m_attributes;
+};
+
+// Um draw call e o estado de que ele precisa
+struct DrawPacket {
+  std::uint64_t m_key{};
+
+  GLuint m_program{};
+  GLuint m_vao{};
+  BlendMode m_blend{BlendMode::Opaque};
+
+  GLenum m_mode{GL_TRIANGLES};
+  GLint m_first{};
+  GLsizei m_count{};
+  // Indices GL_UNSIGNED_INT do EBO do VAO; m_first e o primeiro indice
+  bool m_indexed{false};
+  GLsizei m_instances{1};
+
+  const InstanceLayout *m_instanceLayout{};
+  GLuint m_instanceBuffer{};
+  GLintptr m_instanceOffset{};
+
+  std::uint32_t m_firstUniform{};
+  std::uint32_t m_uniformCount{};
+};
+
+// Fila de desenho do quadro. Os modulos enviam pacotes em vez de chamar o
+// OpenGL; execute() ordena os pacotes por uma chave de 64 bits
+//   camada (8) | blend (2) | programa (16) | VAO (16) | ordem de envio (22)
+// e so troca programa, VAO e blend quando o pacote seguinte usa outro. A
+// camada e a secao do perfilador em que o pacote e medido, entao a ordem das
+// secoes (Stars, Clouds, Asteroids, Cat) e a ordem de desenho. O estado e
+// aplicado por um GLStateCache, que tambem evita uniformes repetidos
+class RenderQueue {
+ public:
+  using Layer = FrameProfiler::Section;
+
+  DrawPacket &submit(Layer layer, GLuint program, GLuint vao,
+                     BlendMode blend = BlendMode::Opaque);
+
+  // Uniformes do ultimo pacote enviado
+  void uniform(GLint location, float value);
+  void uniform(GLint location, glm::vec2 value);
+  void uniform(GLint location, glm::vec4 value);
+
+  void execute(FrameProfiler &profiler);
+
+  // Chamado quando os programas sao recriados
+  void clearStateCache() { m_state.clear(); }
+
+ private:
+  struct Uniform {
+    GLint m_location{-1};
+    GLint m_components{};
+    std::array<float, 4> m_values{};
+  };
+
+  std::vector<DrawPacket> m_packets;
+  std::vector<Uniform> m_uniforms;
+  GLStateCache m_state;
+
+  void addUniform(GLint location, GLint components,
+                  std::array<float, 4> values);
+  void draw(const DrawPacket &packet);
+};
+
+#endif
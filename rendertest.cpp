@@ -0,0 +1,131 @@
+#include "rendertest.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+
+bool Image::savePpm(const std::string &path) const {
+  std::ofstream file{path, std::ios::binary};
+  file << "P6\n" << m_width << ' ' << m_height << "\n255\n";
+  file.write(reinterpret_cast<const char *>(m_pixels.data()),
+             static_cast<std::streamsize>(m_pixels.size()));
+  return static_cast<bool>(file);
+}
+
+bool Image::loadPpm(const std::string &path) {
+  std::ifstream file{path, std::ios::binary};
+  std::string magic;
+  int maxValue{};
+  file >> magic >> m_width >> m_height >> maxValue;
+  if (!file || magic != "P6" || maxValue != 255 || m_width <= 0 ||
+      m_height <= 0) {
+    return false;
+  }
+  file.get();  // um unico espaco separa o cabecalho dos pixels
+
+  m_pixels.resize(static_cast<std::size_t>(m_width) * m_height * 3);
+  file.read(reinterpret_cast<char *>(m_pixels.data()),
+            static_cast<std::streamsize>(m_pixels.size()));
+  return static_cast<bool>(file);
+}
+
+ImageDifference compareImages(const Image &image, const Image &golden,
+                              int tolerance) {
+  ImageDifference difference;
+  if (image.m_width != golden.m_width || image.m_height != golden.m_height) {
+    difference.m_sizeMismatch = true;
+    return difference;
+  }
+
+  difference.m_totalPixels = image.m_pixels.size() / 3;
+  for (std::size_t pixel{0}; pixel < difference.m_totalPixels; ++pixel) {
+    int largest{0};
+    for (std::size_t channel{0}; channel < 3; ++channel) {
+      const auto index{pixel * 3 + channel};
+      largest = std::max(largest, std::abs(image.m_pixels[index] -
+                                           golden.m_pixels[index]));
+    }
+    difference.m_maxChannelDifference =
+        std::max(difference.m_maxChannelDifference, largest);
+    if (largest > tolerance) ++difference.m_mismatchedPixels;
+  }
+  return difference;
+}
+
+void OffscreenTarget::initializeGL(GLsizei width, GLsizei height) {
+  terminateGL();
+  m_width = width;
+  m_height = height;
+
+  m_colorBuffer = GLRenderbuffer{GLResourceRegistry::Owner::Targets};
+  abcg::glBindRenderbuffer(GL_RENDERBUFFER, m_colorBuffer);
+  renderbufferStorage(m_colorBuffer, 0, width, height);
+  abcg::glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+  m_framebuffer = GLFramebuffer{GLResourceRegistry::Owner::Targets};
+  abcg::glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+  abcg::glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                  GL_RENDERBUFFER, m_colorBuffer);
+  const auto status{abcg::glCheckFramebufferStatus(GL_FRAMEBUFFER)};
+  abcg::glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+  if (status != GL_FRAMEBUFFER_COMPLETE) {
+    throw abcg::Exception{
+        abcg::Exception::Runtime("Offscreen framebuffer is incomplete")};
+  }
+}
+
+void OffscreenTarget::terminateGL() {
+  m_framebuffer.reset();
+  m_colorBuffer.reset();
+}
+
+void OffscreenTarget::bind() const {
+  abcg::glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+  abcg::glViewport(0, 0, m_width, m_height);
+}
+
+void OffscreenTarget::unbind() const {
+  abcg::glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+// Le o framebuffer (de baixo para cima no OpenGL) e inverte as linhas
+Image OffscreenTarget::read() const {
+  Image image{m_width, m_height, {}};
+  const auto rowSize{static_cast<std::size_t>(m_width) * 4};
+  std::vector<std::uint8_t> rgba(rowSize * m_height);
+
+  abcg::glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+  abcg::glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  abcg::glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE,
+                     rgba.data());
+  abcg::glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+  image.m_pixels.reserve(static_cast<std::size_t>(m_width) * m_height * 3);
+  for (auto row{m_height}; row-- > 0;) {
+    const auto *source{rgba.data() + static_cast<std::size_t>(row) * rowSize};
+    for (GLsizei column{0}; column < m_width; ++column) {
+      image.m_pixels.insert(image.m_pixels.end(), source + column * 4,
+                            source + column * 4 + 3);
+    }
+  }
+  return image;
+}
+
+RenderTestSettings RenderTestSettings::fromArguments(int argc, char **argv) {
+  RenderTestSettings settings;
+  for (int arg{1}; arg < argc; ++arg) {
+    const std::string option{argv[arg]};
+    const auto hasValue{arg + 1 < argc};
+    if (option == "--render-test" && hasValue) {
+      settings.m_outputDir = argv[++arg];
+    } else if (option == "--golden" && hasValue) {
+      settings.m_goldenDir = argv[++arg];
+    } else if (option == "--frames" && hasValue) {
+      settings.m_frames = std::max(1, std::atoi(argv[++arg]));
+    } else if (option == "--update-golden") {
+      settings.m_updateGolden = true;
+    }
+  }
+  return settings;
+}
@@ -0,0 +1,92 @@
+#ifndef RENDERTEST_HPP_
+#define RENDERTEST_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "abcg.hpp"
+#include "glresource.hpp"
+
+// Imagem RGB com 8 bits por canal, linhas de cima para baixo
+struct Image {
+  int m_width{};
+  int m_height{};
+  std::vector<std::uint8_t> m_pixels;
+
+  // PPM binario (P6)
+  [[nodiscard]] bool savePpm(const std::string &path) const;
+  bool loadPpm(const std::string &path);
+};
+
+struct ImageDifference {
+  int m_maxChannelDifference{};
+  // Pixels com algum canal diferindo mais que a tolerancia
+  std::size_t m_mismatchedPixels{};
+  std::size_t m_totalPixels{};
+  bool m_sizeMismatch{false};
+
+  [[nodiscard]] float mismatchedFraction() const {
+    return m_totalPixels == 0 ? 0.0f
+                              : static_cast<float>(m_mismatchedPixels) /
+                                    static_cast<float>(m_totalPixels);
+  }
+};
+
+[[nodiscard]] ImageDifference compareImages(const Image &image,
+                                            const Image &golden,
+                                            int tolerance);
+
+// Framebuffer fora da tela (renderbuffer RGBA8) onde o teste desenha a cena
+class OffscreenTarget {
+ public:
+  void initializeGL(GLsizei width, GLsizei height);
+  void terminateGL();
+
+  void bind() const;
+  void unbind() const;
+  [[nodiscard]] Image read() const;
+
+  [[nodiscard]] GLsizei width() const { return m_width; }
+  [[nodiscard]] GLsizei height() const { return m_height; }
+
+ private:
+  GLFramebuffer m_framebuffer;
+  GLRenderbuffer m_colorBuffer;
+  GLsizei m_width{};
+  GLsizei m_height{};
+};
+
+// Modo de teste de renderizacao (catrun --render-test <dir>): desenha uma
+// cena fixa (sementes e numero de passos fixos) nos temas dia e noite em um
+// OffscreenTarget, salva cada quadro em <dir>/<tema>.ppm, compara com
+// <golden>/<tema>.ppm e imprime o tempo medio de cada passe. Depois mede o
+// restart da janela, que nao pode criar nem liberar objetos GL. Sem monitor,
+// a janela usa o driver "offscreen" do SDL (EGL; ex.: Mesa llvmpipe)
+struct RenderTestSettings {
+  std::string m_outputDir;
+  std::string m_goldenDir{"goldens"};
+  bool m_updateGolden{false};
+
+  int m_frames{60};
+  int m_ticks{360};
+  int m_restarts{100};
+  unsigned m_seed{1234};
+  GLsizei m_width{600};
+  GLsizei m_height{600};
+
+  // Diferenca aceita por canal e fracao maxima de pixels fora dela
+  int m_tolerance{8};
+  float m_maxMismatch{0.001f};
+
+  // Recebe 0 (sucesso) ou 1; o main o usa como codigo de saida
+  int *m_exitCode{};
+
+  [[nodiscard]] bool enabled() const { return !m_outputDir.empty(); }
+
+  // Le --render-test, --golden, --update-golden e --frames
+  static RenderTestSettings fromArguments(int argc, char **argv);
+};
+
+#endif
@@ -0,0 +1,164 @@
+#include "replay.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace {
+constexpr char magic[4]{'C', 'R', 'R', 'P'};
+
+// Flags gravadas em cada passo
+constexpr std::uint8_t restartFlag{1 << 0};
+constexpr std::uint8_t mouseFlag{1 << 1};
+constexpr std::uint8_t asteroidCollisionsFlag{1 << 2};
+
+template <typename T>
+void write(std::vector<std::uint8_t> &data, const T &value) {
+  const auto *bytes{reinterpret_cast<const std::uint8_t *>(&value)};
+  data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+bool read(const std::vector<std::uint8_t> &data, std::size_t &offset,
+          T &value) {
+  if (offset + sizeof(T) > data.size()) return false;
+  std::memcpy(&value, data.data() + offset, sizeof(T));
+  offset += sizeof(T);
+  return true;
+}
+}  // namespace
+
+void ReplayRecorder::begin(Simulation &simulation, unsigned roundSeed,
+                           unsigned starsSeed) {
+  m_header = ReplayHeader{};
+  m_header.m_simulationSeed = simulation.seed();
+  m_header.m_roundSeed = roundSeed;
+  m_header.m_starsSeed = starsSeed;
+  m_header.m_tickRate = simulation.tickRate();
+  m_data.clear();
+  m_ticks = 0;
+  m_recording = true;
+
+  // A partida gravada comeca do zero, com a semente da partida. O estado
+  // inicial fica reprodutivel a partir de initialize() + reseed()
+  simulation.initialize(simulation.seed());
+  simulation.reseed(roundSeed);
+  simulation.requestRestart();
+  simulation.m_recorder = this;
+}
+
+void ReplayRecorder::end(Simulation &simulation) {
+  if (simulation.m_recorder == this) {
+    simulation.m_recorder = nullptr;
+  }
+  m_recording = false;
+}
+
+void ReplayRecorder::record(const TickInput &input, std::uint32_t checksum) {
+  std::uint8_t flags{0};
+  if (input.m_restart) flags |= restartFlag;
+  if (input.m_mouseMoved) flags |= mouseFlag;
+  if (input.m_asteroidCollisions) flags |= asteroidCollisionsFlag;
+
+  write(m_data, static_cast<std::uint8_t>(input.m_keys.to_ulong()));
+  write(m_data, flags);
+  if (input.m_mouseMoved) {
+    write(m_data, input.m_mouse.x);
+    write(m_data, input.m_mouse.y);
+  }
+  write(m_data, checksum);
+  ++m_ticks;
+}
+
+// Maior passo gravado: teclas, flags, mouse e checksum
+void ReplayRecorder::reserve(std::size_t ticks) {
+  constexpr std::size_t maxTickSize{2 * sizeof(std::uint8_t) +
+                                    2 * sizeof(float) +
+                                    sizeof(std::uint32_t)};
+  m_data.reserve(ticks * maxTickSize);
+}
+
+bool ReplayRecorder::save(const std::string &path) const {
+  std::vector<std::uint8_t> header;
+  header.insert(header.end(), std::begin(magic), std::end(magic));
+  write(header, m_header.m_version);
+  write(header, m_header.m_simulationSeed);
+  write(header, m_header.m_roundSeed);
+  write(header, m_header.m_starsSeed);
+  write(header, m_header.m_tickRate);
+
+  std::ofstream file{path, std::ios::binary};
+  if (!file) return false;
+  file.write(reinterpret_cast<const char *>(header.data()),
+             static_cast<std::streamsize>(header.size()));
+  file.write(reinterpret_cast<const char *>(m_data.data()),
+             static_cast<std::streamsize>(m_data.size()));
+  return static_cast<bool>(file);
+}
+
+bool ReplayPlayer::load(const std::string &path) {
+  std::ifstream file{path, std::ios::binary};
+  if (!file) return false;
+  std::vector<std::uint8_t> data{std::istreambuf_iterator<char>{file},
+                                 std::istreambuf_iterator<char>{}};
+
+  std::size_t offset{0};
+  char fileMagic[4]{};
+  if (!read(data, offset, fileMagic) ||
+      std::memcmp(fileMagic, magic, sizeof(magic)) != 0) {
+    return false;
+  }
+
+  ReplayHeader header;
+  if (!read(data, offset, header.m_version) || header.m_version != 1 ||
+      !read(data, offset, header.m_simulationSeed) ||
+      !read(data, offset, header.m_roundSeed) ||
+      !read(data, offset, header.m_starsSeed) ||
+      !read(data, offset, header.m_tickRate)) {
+    return false;
+  }
+
+  m_header = header;
+  m_data.assign(data.begin() + static_cast<std::ptrdiff_t>(offset),
+                data.end());
+  return true;
+}
+
+ReplayResult ReplayPlayer::play(Simulation &simulation) const {
+  ReplayResult result;
+
+  simulation.setTickRate(m_header.m_tickRate);
+  simulation.initialize(m_header.m_simulationSeed);
+  simulation.reseed(m_header.m_roundSeed);
+
+  const auto deltaTime{simulation.fixedDeltaTime()};
+  std::size_t offset{0};
+  while (offset < m_data.size()) {
+    std::uint8_t keys{};
+    std::uint8_t flags{};
+    if (!read(m_data, offset, keys) || !read(m_data, offset, flags)) break;
+
+    glm::vec2 mouse{};
+    if ((flags & mouseFlag) != 0 &&
+        (!read(m_data, offset, mouse.x) || !read(m_data, offset, mouse.y))) {
+      break;
+    }
+
+    std::uint32_t checksum{};
+    if (!read(m_data, offset, checksum)) break;
+
+    simulation.m_gameData.m_input = std::bitset<5>{keys};
+    simulation.m_asteroidCollisions = (flags & asteroidCollisionsFlag) != 0;
+    if ((flags & restartFlag) != 0) simulation.requestRestart();
+    if ((flags & mouseFlag) != 0) simulation.moveCatTo(mouse);
+
+    simulation.update(deltaTime);
+
+    if (result.m_firstMismatch < 0 && simulation.checksum() != checksum) {
+      result.m_firstMismatch = static_cast<long>(result.m_ticks);
+    }
+    ++result.m_ticks;
+  }
+
+  return result;
+}
@@ -0,0 +1,69 @@
+#ifndef REPLAY_HPP_
+#define REPLAY_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "simulation.hpp"
+
+// Formato binario do replay (little-endian):
+//   cabecalho: "CRRP", versao, semente da simulacao, semente da partida,
+//              semente das estrelas, passos por segundo
+//   por passo: 1 byte de teclas, 1 byte de flags, posicao do mouse (2 floats,
+//              so quando a flag de mouse esta ligada) e o checksum do estado
+//              depois do passo (uint32)
+// A reproducao so e exata com o mesmo compilador/biblioteca padrao, pois as
+// distribuicoes de <random> nao sao padronizadas entre implementacoes
+struct ReplayHeader {
+  std::uint32_t m_version{1};
+  std::uint32_t m_simulationSeed{};
+  std::uint32_t m_roundSeed{};
+  std::uint32_t m_starsSeed{};
+  float m_tickRate{120.0f};
+};
+
+// Comeca uma partida gravada: a simulacao e reiniciada com a semente da
+// partida e cada passo passa a ser gravado pela propria Simulation
+class ReplayRecorder {
+ public:
+  void begin(Simulation &simulation, unsigned roundSeed, unsigned starsSeed);
+  void end(Simulation &simulation);
+  void record(const TickInput &input, std::uint32_t checksum);
+  // Reserva espaco para ticks passos, para gravar sem alocar memoria
+  void reserve(std::size_t ticks);
+  bool save(const std::string &path) const;
+
+  [[nodiscard]] bool recording() const { return m_recording; }
+  [[nodiscard]] std::size_t ticks() const { return m_ticks; }
+
+ private:
+  ReplayHeader m_header;
+  std::vector<std::uint8_t> m_data;
+  std::size_t m_ticks{};
+  bool m_recording{false};
+};
+
+// Resultado da reproducao: numero de passos simulados e o primeiro passo cujo
+// checksum divergiu da gravacao (ou -1)
+struct ReplayResult {
+  std::size_t m_ticks{};
+  long m_firstMismatch{-1};
+};
+
+// Re-simula uma gravacao o mais rapido possivel, comparando o checksum do
+// estado a cada passo
+class ReplayPlayer {
+ public:
+  bool load(const std::string &path);
+  ReplayResult play(Simulation &simulation) const;
+
+  [[nodiscard]] const ReplayHeader &header() const { return m_header; }
+
+ private:
+  ReplayHeader m_header;
+  std::vector<std::uint8_t> m_data;
+};
+
+#endif
@@ -0,0 +1,82 @@
+#include "scenetarget.hpp"
+
+#include <algorithm>
+
+void SceneTarget::configure(GLsizei width, GLsizei height, GLsizei samples) {
+  if (m_maxSamples < 0) abcg::glGetIntegerv(GL_MAX_SAMPLES, &m_maxSamples);
+  samples = std::clamp(samples, 0, m_maxSamples);
+  width = std::max(width, 1);
+  height = std::max(height, 1);
+
+  if (m_framebuffer != 0 && width == m_width && height == m_height &&
+      samples == m_samples) {
+    return;
+  }
+
+  terminateGL();
+  m_width = width;
+  m_height = height;
+  m_samples = samples;
+
+  constexpr auto owner{GLResourceRegistry::Owner::Targets};
+  m_colorBuffer = GLRenderbuffer{owner};
+  abcg::glBindRenderbuffer(GL_RENDERBUFFER, m_colorBuffer);
+  renderbufferStorage(m_colorBuffer, samples, width, height);
+  m_framebuffer = GLFramebuffer{owner};
+  attach(m_framebuffer, m_colorBuffer);
+
+  if (samples > 0) {
+    m_resolveBuffer = GLRenderbuffer{owner};
+    abcg::glBindRenderbuffer(GL_RENDERBUFFER, m_resolveBuffer);
+    renderbufferStorage(m_resolveBuffer, 0, width, height);
+    m_resolveFramebuffer = GLFramebuffer{owner};
+    attach(m_resolveFramebuffer, m_resolveBuffer);
+  }
+  abcg::glBindRenderbuffer(GL_RENDERBUFFER, 0);
+}
+
+void SceneTarget::attach(GLuint framebuffer, GLuint renderbuffer) {
+  abcg::glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+  abcg::glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                  GL_RENDERBUFFER, renderbuffer);
+  const auto status{abcg::glCheckFramebufferStatus(GL_FRAMEBUFFER)};
+  abcg::glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+  if (status != GL_FRAMEBUFFER_COMPLETE) {
+    throw abcg::Exception{
+        abcg::Exception::Runtime("Scene framebuffer is incomplete")};
+  }
+}
+
+void SceneTarget::terminateGL() {
+  m_framebuffer.reset();
+  m_colorBuffer.reset();
+  m_resolveFramebuffer.reset();
+  m_resolveBuffer.reset();
+}
+
+void SceneTarget::bind() const {
+  abcg::glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+  abcg::glViewport(0, 0, m_width, m_height);
+}
+
+void SceneTarget::present(GLsizei width, GLsizei height) const {
+  GLuint source{m_framebuffer};
+  if (m_samples > 0) {
+    abcg::glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+    abcg::glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_resolveFramebuffer);
+    abcg::glBlitFramebuffer(0, 0, m_width, m_height, 0, 0, m_width, m_height,
+                            GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    source = m_resolveFramebuffer;
+  }
+
+  // Filtro linear: a ampliacao fica suave em vez de pixelada
+  abcg::glBindFramebuffer(GL_READ_FRAMEBUFFER, source);
+  abcg::glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+  abcg::glBlitFramebuffer(0, 0, m_width, m_height, 0, 0, width, height,
+                          GL_COLOR_BUFFER_BIT,
+                          width == m_width && height == m_height ? GL_NEAREST
+                                                                 : GL_LINEAR);
+  abcg::glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  abcg::glViewport(0, 0, width, height);
+}
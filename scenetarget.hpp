@@ -0,0 +1,39 @@
+#ifndef SCENETARGET_HPP_
+#define SCENETARGET_HPP_
+
+#include "abcg.hpp"
+#include "glresource.hpp"
+
+// Framebuffer onde a cena e desenhada em resolucao reduzida (e com MSAA
+// opcional) antes de ser ampliada para a janela. Com amostras, o conteudo e
+// resolvido em um segundo framebuffer do mesmo tamanho, pois o blit de um
+// framebuffer multiamostrado nao pode mudar de escala
+class SceneTarget {
+ public:
+  // Recria os renderbuffers apenas se o tamanho ou as amostras mudaram
+  void configure(GLsizei width, GLsizei height, GLsizei samples);
+  void terminateGL();
+
+  void bind() const;
+  // Resolve (se preciso) e amplia o conteudo para o framebuffer padrao
+  void present(GLsizei width, GLsizei height) const;
+
+  [[nodiscard]] GLsizei width() const { return m_width; }
+  [[nodiscard]] GLsizei height() const { return m_height; }
+  [[nodiscard]] GLsizei samples() const { return m_samples; }
+
+ private:
+  GLFramebuffer m_framebuffer;
+  GLRenderbuffer m_colorBuffer;
+  GLFramebuffer m_resolveFramebuffer;
+  GLRenderbuffer m_resolveBuffer;
+  GLsizei m_width{};
+  GLsizei m_height{};
+  GLsizei m_samples{};
+  // GL_MAX_SAMPLES, consultado na primeira configuracao
+  GLint m_maxSamples{-1};
+
+  static void attach(GLuint framebuffer, GLuint renderbuffer);
+};
+
+#endif
@@ -0,0 +1,375 @@
+#include "simulation.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <glm/geometric.hpp>
+#include <glm/gtx/fast_trigonometry.hpp>
+
+#include "replay.hpp"
+
+void CatState::reset() {
+  m_rotation = 0.0f;
+  m_translation = glm::vec2(0);
+  m_velocity = glm::vec2(0);
+  storePrevious();
+}
+
+void CatState::storePrevious() {
+  m_previousRotation = m_rotation;
+  m_previousTranslation = m_translation;
+}
+
+void CatState::update(const GameData &gameData, float deltaTime) {
+  // Move
+  if (gameData.m_input[static_cast<size_t>(Input::Left)] &&
+      m_translation.x > -(1 - m_scale))
+    m_translation += (glm::vec2{-0.7f, 0.0f}) * deltaTime;
+  if (gameData.m_input[static_cast<size_t>(Input::Right)] &&
+      m_translation.x < (1 - m_scale))
+    m_translation += (glm::vec2{0.7f, 0.0f}) * deltaTime;
+  if (gameData.m_input[static_cast<size_t>(Input::Up)] &&
+      m_translation.y < (1 - m_scale))
+    m_translation += (glm::vec2{0.0f, 0.7f}) * deltaTime;
+  if (gameData.m_input[static_cast<size_t>(Input::Down)] &&
+      m_translation.y > -(1 - m_scale))
+    m_translation += (glm::vec2{0.0f, -0.7f}) * deltaTime;
+}
+
+// Move o gato para a posicao do mouse, respeitando os limites da tela. A
+// posicao anterior tambem e atualizada para o desenho nao interpolar o salto
+void CatState::moveTo(glm::vec2 position) {
+  if (position.x > -(1 - m_scale) && position.x < (1 - m_scale)) {
+    m_translation.x = position.x;
+    m_previousTranslation.x = position.x;
+  }
+  if (position.y > -(1 - m_scale) && position.y < (1 - m_scale)) {
+    m_translation.y = position.y;
+    m_previousTranslation.y = position.y;
+  }
+}
+
+void Simulation::initialize(unsigned seed) {
+  m_seed = seed;
+  m_randomEngine.seed(seed);
+  m_accumulator = 0.0f;
+  m_pendingRestart = false;
+  m_pendingMouseMoved = false;
+
+  // Cria a biblioteca de formatos compartilhada por todos os asteroids
+  m_shapes.generate(m_randomEngine, m_shapeCount);
+
+  m_grid.initialize(glm::vec2{-1.0f}, glm::vec2{1.0f}, 0.25f);
+  m_grid.reserve(m_asteroidCapacity);
+  m_asteroids.reserve(m_asteroidCapacity);
+  m_neighbors.reserve(m_asteroidCapacity);
+  m_catCandidates.reserve(m_asteroidCapacity);
+  m_candidateCenters.reserve(m_asteroidCapacity);
+  m_candidateRadii.reserve(m_asteroidCapacity);
+  m_catHits.reserve(overlapMaskWords(m_asteroidCapacity));
+
+  m_gameData.m_state = State::Initial;
+  reset();
+}
+
+// Função de restart do jogo
+void Simulation::restart() {
+  reset();
+  m_gameData.m_state = State::Playing;
+}
+
+void Simulation::reset() {
+  m_pedras_desviadas = 0;
+  m_screenTime = 0.0f;
+  m_spawnTime = 0.0f;
+  m_gameData.m_input.reset();
+
+  m_cat.reset();
+
+  m_asteroids.clear();
+  m_grid.clear();
+  std::uniform_real_distribution<float> randomDist{-1.0f, 1.0f};
+  createAsteroid(glm::vec2{randomDist(m_randomEngine), 1});
+}
+
+int Simulation::advance(float frameTime) {
+  m_accumulator += std::min(frameTime, m_maxFrameTime);
+
+  const auto step{fixedDeltaTime()};
+  int steps{0};
+  while (m_accumulator >= step) {
+    update(step);
+    m_accumulator -= step;
+    ++steps;
+  }
+  return steps;
+}
+
+void Simulation::handleInput(const InputEvent &event) {
+  const auto key{static_cast<size_t>(event.m_key)};
+  switch (event.m_type) {
+    case InputEvent::Type::KeyDown:
+      m_gameData.m_input.set(key);
+      break;
+    case InputEvent::Type::KeyUp:
+      m_gameData.m_input.reset(key);
+      break;
+    case InputEvent::Type::Mouse:
+      moveCatTo(event.m_position);
+      break;
+    case InputEvent::Type::Restart:
+      requestRestart();
+      break;
+    case InputEvent::Type::AsteroidCollisions:
+      m_asteroidCollisions = !m_asteroidCollisions;
+      break;
+  }
+}
+
+// Aplica as entradas pendentes e devolve a entrada efetiva deste passo
+TickInput Simulation::applyInput() {
+  TickInput input;
+  input.m_keys = m_gameData.m_input;
+  input.m_restart = m_pendingRestart;
+  input.m_mouseMoved = m_pendingMouseMoved;
+  input.m_mouse = m_pendingMouse;
+  input.m_asteroidCollisions = m_asteroidCollisions;
+
+  m_pendingRestart = false;
+  m_pendingMouseMoved = false;
+
+  if (input.m_restart) restart();
+  if (input.m_mouseMoved) m_cat.moveTo(input.m_mouse);
+
+  return input;
+}
+
+void Simulation::update(float deltaTime) {
+  const auto input{applyInput()};
+
+  m_cat.storePrevious();
+  m_asteroids.storePrevious();
+
+  m_screenTime += deltaTime;
+  m_spawnTime += deltaTime;
+
+  m_cat.update(m_gameData, deltaTime);
+  updateAsteroids(deltaTime);
+  float interval;
+
+  // define parametros para ordenacao de asteroids gerados
+  std::uniform_real_distribution<float> randomDist{-1.0f, 1.0f};
+  int ordenation = std::signbit(randomDist(m_randomEngine));
+  int starting_point = 1;
+  if (ordenation) starting_point = -1;
+
+  if (m_gameData.m_state == State::Playing) {
+    // controla tamanho do intervalo de acordo com tempo passado, baseado no
+    // tempo total definido no arquivo .hpp
+    if (remainingTime() < m_total_time / 2.0f &&
+        remainingTime() > m_total_time / 6.0f) {
+      interval = 0.75f;
+    } else if (remainingTime() < m_total_time / 6.0f) {
+      interval = 1.2f;
+    } else {
+      interval = 1.0f;
+    }
+
+    // cria asteroides a cada intervalo, modificando sua velocidade segundo o
+    // tempo
+    if (m_spawnTime > interval) {
+      m_spawnTime = 0.0f;
+      float inverse_velocity = remainingTime() / (m_total_time / 5.0f);
+      createAsteroid(glm::vec2{randomDist(m_randomEngine), starting_point},
+                     inverse_velocity, ordenation);
+    }
+
+    checkCollisions();
+    checkWinCondition();
+  } else if (m_spawnTime > 5.0f) {
+    m_spawnTime = 0.0f;
+    for ([[maybe_unused]] auto i : {0, 1, 2}) {
+      createAsteroid(glm::vec2{randomDist(m_randomEngine), starting_point},
+                     5.5f, ordenation);
+    }
+  }
+
+  if (m_recorder != nullptr) {
+    m_recorder->record(input, checksum());
+  }
+}
+
+namespace {
+// FNV-1a de 32 bits sobre a representacao binaria dos valores
+void hashBytes(std::uint32_t &hash, const void *data, std::size_t size) {
+  const auto *bytes{static_cast<const unsigned char *>(data)};
+  for (std::size_t i{0}; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 16777619u;
+  }
+}
+
+template <typename T>
+void hashVector(std::uint32_t &hash, const std::vector<T> &values) {
+  if (!values.empty()) {
+    hashBytes(hash, values.data(), values.size() * sizeof(T));
+  }
+}
+}  // namespace
+
+std::uint32_t Simulation::checksum() const {
+  std::uint32_t hash{2166136261u};
+
+  const auto state{static_cast<int>(m_gameData.m_state)};
+  const auto count{m_asteroids.size()};
+  hashBytes(hash, &state, sizeof(state));
+  hashBytes(hash, &m_pedras_desviadas, sizeof(m_pedras_desviadas));
+  hashBytes(hash, &m_screenTime, sizeof(m_screenTime));
+  hashBytes(hash, &m_spawnTime, sizeof(m_spawnTime));
+  hashBytes(hash, &m_cat.m_translation, sizeof(m_cat.m_translation));
+  hashBytes(hash, &count, sizeof(count));
+  hashVector(hash, m_asteroids.m_translations);
+  hashVector(hash, m_asteroids.m_velocities);
+  hashVector(hash, m_asteroids.m_rotations);
+  hashVector(hash, m_asteroids.m_shapeIndices);
+
+  return hash;
+}
+
+// Atualizacao dos asteroids (girar e se mover na tela). Asteroids que saem
+// da tela sao removidos e contados como desviados
+void Simulation::updateAsteroids(float deltaTime) {
+  auto &translations{m_asteroids.m_translations};
+  auto &rotations{m_asteroids.m_rotations};
+  const auto &velocities{m_asteroids.m_velocities};
+  const auto &angularVelocities{m_asteroids.m_angularVelocities};
+  const auto &scales{m_asteroids.m_scales};
+
+  for (std::size_t index{0}; index < m_asteroids.size(); ++index) {
+    rotations[index] = glm::wrapAngle(rotations[index] +
+                                      angularVelocities[index] * deltaTime);
+    translations[index] += velocities[index] * deltaTime;
+    m_grid.move(m_asteroids.handleAt(index).m_slot, translations[index]);
+  }
+
+  if (m_asteroidCollisions) {
+    resolveAsteroidCollisions();
+  }
+
+  // Percorre de tras para frente para que o swap-and-pop nao pule ninguem
+  for (auto index{m_asteroids.size()}; index-- > 0;) {
+    if (translations[index].y < -(1.0f + scales[index]) ||
+        translations[index].y > (1.0f + scales[index])) {
+      m_grid.remove(m_asteroids.handleAt(index).m_slot);
+      m_asteroids.remove(index);
+      m_pedras_desviadas += 1;
+    }
+  }
+}
+
+// Colisao entre asteroides usando a grade: cada asteroide consulta apenas os
+// vizinhos das celulas proximas (aproximadamente O(n)). Os pares colidem de
+// forma elastica (massas iguais) e sao separados ao longo da normal. Os
+// vizinhos sao copiados para m_neighbors antes de qualquer m_grid.move: mover
+// um corpo de celula altera os vetores das celulas que a consulta percorre
+void Simulation::resolveAsteroidCollisions() {
+  auto &translations{m_asteroids.m_translations};
+  auto &velocities{m_asteroids.m_velocities};
+
+  for (std::size_t index{0}; index < m_asteroids.size(); ++index) {
+    const auto slot{m_asteroids.handleAt(index).m_slot};
+
+    m_grid.query(translations[index], m_grid.radius(slot), m_neighbors);
+    for (const auto other : m_neighbors) {
+      // Cada par e tratado uma unica vez
+      if (other <= slot) continue;
+      const auto otherIndex{m_asteroids.indexOfSlot(other)};
+
+      auto offset{translations[otherIndex] - translations[index]};
+      auto distance{glm::length(offset)};
+      if (distance <= 0.0f) {
+        offset = glm::vec2{1.0f, 0.0f};
+        distance = 0.0f;
+      } else {
+        offset /= distance;
+      }
+
+      // Troca as componentes de velocidade ao longo da normal
+      const auto approach{
+          glm::dot(velocities[index] - velocities[otherIndex], offset)};
+      if (approach > 0.0f) {
+        velocities[index] -= offset * approach;
+        velocities[otherIndex] += offset * approach;
+      }
+
+      // Separa os dois asteroides
+      const auto overlap{m_grid.radius(slot) + m_grid.radius(other) -
+                         distance};
+      translations[index] -= offset * (overlap * 0.5f);
+      translations[otherIndex] += offset * (overlap * 0.5f);
+      m_grid.move(slot, translations[index]);
+      m_grid.move(other, translations[otherIndex]);
+    }
+  }
+}
+
+// Funcao para checar colisao entre o gato e os asteroides (os asteroides que
+// saem da tela ja sao removidos em updateAsteroids). A grade devolve os
+// asteroides das celulas ao alcance do gato, com os centros e os raios de
+// colisao (escala * 0.85) que ela guarda; o circulo do gato (escala * 0.9)
+// e testado contra todos eles de uma vez, com o kernel vetorizado
+void Simulation::checkCollisions() {
+  // Verifica a colisão entre gato e asteróides
+  const auto radius{m_cat.m_scale * 0.9f};
+  m_grid.candidates(m_cat.m_translation, radius, m_catCandidates,
+                    m_candidateCenters, m_candidateRadii);
+
+  // Os raios ja estao multiplicados por m_collisionRadius
+  m_catHits.resize(overlapMaskWords(m_catCandidates.size()));
+  const auto hits{overlapCircles(m_cat.m_translation, radius,
+                                 m_candidateCenters.data(),
+                                 m_candidateRadii.data(), 1.0f,
+                                 m_catCandidates.size(), m_catHits.data())};
+  if (hits > 0) m_gameData.m_state = State::GameOver;
+}
+
+// Funcao para checar se o tempo total de jogo passou (vitoria)
+void Simulation::checkWinCondition() {
+  if (m_screenTime >= m_total_time && m_gameData.m_state == State::Playing) {
+    m_gameData.m_state = State::Win;
+  }
+}
+
+// Criando asteroids com posição, constante de velocidade inversa, ordenacao
+// (cima ou baixo) e escala. O formato e sorteado da biblioteca m_shapes
+AsteroidHandle Simulation::createAsteroid(glm::vec2 translation,
+                                          float inverse_velocity,
+                                          int ordenation, float scale) {
+  auto &re{m_randomEngine};
+
+  // Escolher um formato aleatorio da biblioteca
+  std::uniform_int_distribution<int> randomShape(0, m_shapes.size() - 1);
+  const auto shapeIndex{randomShape(re)};
+
+  // Escolher uma intensidade de cor aleatoria na escala
+  std::uniform_real_distribution<float> randomIntensity{0.6f, 0.9f};
+  const auto intensity{randomIntensity(re)};
+
+  // Velocidade angular aleatoria
+  std::uniform_real_distribution<float> randomDist{-1.0f, 1.0f};
+  const auto angularVelocity{randomDist(re)};
+
+  // Direção aleatoria
+  glm::vec2 direction{0, -1};
+
+  if (ordenation) {
+    direction.y = 1;
+  }
+
+  const auto velocity{glm::normalize(direction) / inverse_velocity};
+
+  const auto handle{m_asteroids.add(translation, velocity, angularVelocity,
+                                    scale, intensity, shapeIndex)};
+  m_grid.insert(handle.m_slot, translation, scale * m_collisionRadius);
+
+  return handle;
+}
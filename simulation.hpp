@@ -0,0 +1,165 @@
+#ifndef SIMULATION_HPP_
+#define SIMULATION_HPP_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+#include <glm/vec2.hpp>
+
+#include "asteroidpool.hpp"
+#include "asteroidshapes.hpp"
+#include "gamedata.hpp"
+#include "overlapkernel.hpp"
+#include "spatialgrid.hpp"
+
+// Estado do gato usado pela simulacao (sem nenhum recurso OpenGL)
+struct CatState {
+  float m_rotation{};
+  float m_scale{0.125f};
+  glm::vec2 m_translation{glm::vec2(0)};
+  glm::vec2 m_velocity{glm::vec2(0)};
+
+  // Estado do passo anterior, usado para interpolar o desenho
+  float m_previousRotation{};
+  glm::vec2 m_previousTranslation{glm::vec2(0)};
+
+  void reset();
+  void storePrevious();
+  void update(const GameData &gameData, float deltaTime);
+  void moveTo(glm::vec2 position);
+
+  [[nodiscard]] glm::vec2 interpolatedTranslation(float alpha) const {
+    return m_previousTranslation +
+           (m_translation - m_previousTranslation) * alpha;
+  }
+};
+
+// Entrada aplicada no inicio de um passo da simulacao. E o que o
+// ReplayRecorder grava a cada passo
+struct TickInput {
+  std::bitset<5> m_keys;
+  bool m_restart{false};
+  bool m_mouseMoved{false};
+  bool m_asteroidCollisions{false};
+  glm::vec2 m_mouse{};
+};
+
+// Evento de entrada vindo da janela. Pode ser aplicado diretamente ou
+// passar pela fila do SimulationThread
+struct InputEvent {
+  enum class Type { KeyDown, KeyUp, Mouse, Restart, AsteroidCollisions };
+  Type m_type{Type::KeyDown};
+  Input m_key{Input::Up};
+  glm::vec2 m_position{};
+};
+
+class ReplayRecorder;
+
+// Interpola angulos pelo menor arco, para que o wrapAngle nao cause saltos
+inline float interpolateAngle(float previous, float current, float alpha) {
+  constexpr float twoPi{6.28318530718f};
+  auto delta{std::remainder(current - previous, twoPi)};
+  return previous + delta * alpha;
+}
+
+// Logica do jogo: gato, asteroides, agenda de criacao de asteroides,
+// temporizadores, colisoes e condicao de vitoria. Nao depende de OpenGL nem
+// de SDL, entao pode ser executada sem janela (ver headless.cpp). Os
+// renderizadores apenas leem este estado
+class Simulation {
+ public:
+  void initialize(unsigned seed);
+  void reseed(unsigned seed) { m_randomEngine.seed(seed); }
+  void restart();
+  void update(float deltaTime);
+
+  // Entradas que so sao aplicadas no inicio do proximo passo, para que a
+  // partida possa ser reproduzida por um replay
+  void requestRestart() { m_pendingRestart = true; }
+  void moveCatTo(glm::vec2 position) {
+    m_pendingMouse = position;
+    m_pendingMouseMoved = true;
+  }
+  void handleInput(const InputEvent &event);
+
+  // Hash (FNV-1a) do estado da simulacao, comparado passo a passo no replay
+  [[nodiscard]] std::uint32_t checksum() const;
+  [[nodiscard]] unsigned seed() const { return m_seed; }
+
+  // Passo fixo: acumula o tempo do quadro e executa quantos passos de
+  // 1/m_tickRate couberem. Retorna o numero de passos executados; alpha()
+  // e a fracao do proximo passo ja decorrida, usada para interpolar o desenho
+  int advance(float frameTime);
+  void setTickRate(float tickRate) { m_tickRate = tickRate; }
+  [[nodiscard]] float tickRate() const { return m_tickRate; }
+  [[nodiscard]] float fixedDeltaTime() const { return 1.0f / m_tickRate; }
+  [[nodiscard]] float alpha() const { return m_accumulator * m_tickRate; }
+
+  [[nodiscard]] float remainingTime() const {
+    return static_cast<float>(m_total_time) - m_screenTime;
+  }
+
+  GameData m_gameData;
+  CatState m_cat;
+  AsteroidPool m_asteroids;
+  AsteroidShapes m_shapes;
+
+  // Broadphase: grade indexada pelo slot de cada asteroide no pool, mantida
+  // incrementalmente em updateAsteroids(). O raio guardado e o de colisao
+  SpatialGrid m_grid;
+  bool m_asteroidCollisions{false};
+  // Vizinhos de um asteroide na consulta de resolveAsteroidCollisions()
+  std::vector<std::uint32_t> m_neighbors;
+  // Candidatos da grade perto do gato (slots, centros e raios de colisao) e
+  // a mascara de colisao com cada um, de checkCollisions()
+  std::vector<std::uint32_t> m_catCandidates;
+  std::vector<glm::vec2> m_candidateCenters;
+  std::vector<float> m_candidateRadii;
+  std::vector<std::uint64_t> m_catHits;
+  static constexpr float m_collisionRadius{0.85f};
+  // Capacidade reservada no initialize() para o pool, a grade e as listas
+  // de trabalho; ate ela, os passos da simulacao nao alocam memoria
+  static constexpr std::size_t m_asteroidCapacity{256};
+
+  int m_pedras_desviadas{0};
+  const int m_total_time{60};
+  int m_shapeCount{32};
+
+  // Quando definido, cada passo e gravado (entrada e checksum)
+  ReplayRecorder *m_recorder{};
+
+ private:
+  // Acesso aos passos internos para os microbenchmarks (bench.cpp)
+  friend struct SimulationBenchmark;
+
+  // Tempo desde o inicio da partida e desde o ultimo asteroide criado
+  float m_screenTime{};
+  float m_spawnTime{};
+
+  float m_tickRate{120.0f};
+  float m_accumulator{};
+  // Limite de tempo por quadro, para nao entrar em espiral apos um travamento
+  static constexpr float m_maxFrameTime{0.25f};
+
+  unsigned m_seed{};
+  std::default_random_engine m_randomEngine;
+
+  bool m_pendingRestart{false};
+  bool m_pendingMouseMoved{false};
+  glm::vec2 m_pendingMouse{};
+
+  void reset();
+  TickInput applyInput();
+  void updateAsteroids(float deltaTime);
+  void resolveAsteroidCollisions();
+  void checkCollisions();
+  void checkWinCondition();
+
+  AsteroidHandle createAsteroid(glm::vec2 translation = glm::vec2(0),
+                                float inverse_velocity = 7.0f,
+                                int ordenation = 0, float scale = 0.25f);
+};
+
+#endif
@@ -0,0 +1,104 @@
+#include "simulationthread.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+void SimulationSnapshot::capture(const Simulation &simulation) {
+  m_gameData = simulation.m_gameData;
+  m_cat = simulation.m_cat;
+  // Copia por atribuicao: reaproveita a memoria dos vetores do snapshot
+  m_asteroids = simulation.m_asteroids;
+  m_pedras_desviadas = simulation.m_pedras_desviadas;
+  m_remainingTime = simulation.remainingTime();
+  m_time = std::chrono::steady_clock::now();
+}
+
+void SimulationThread::start(Simulation &simulation) {
+  stop();
+
+  m_simulation = &simulation;
+  m_deltaTime = simulation.fixedDeltaTime();
+
+  // Os tres buffers comecam com o estado atual
+  for ([[maybe_unused]] auto i : {0, 1, 2}) {
+    m_snapshots.back().capture(simulation);
+    m_snapshots.publish();
+    m_snapshots.update();
+  }
+
+  m_running = true;
+  m_thread = std::thread{&SimulationThread::run, this};
+}
+
+void SimulationThread::stop() {
+  if (!m_thread.joinable()) return;
+
+  m_running = false;
+  m_thread.join();
+
+  // Entradas que chegaram depois do ultimo passo, e por fim as que ainda
+  // esperavam espaco na fila
+  InputEvent event;
+  while (m_inputs.pop(event)) {
+    m_simulation->handleInput(event);
+  }
+  for (const auto &pending : m_overflow) {
+    m_simulation->handleInput(pending);
+  }
+  m_overflow.clear();
+}
+
+void SimulationThread::push(const InputEvent &event) {
+  flush();
+  if (!m_overflow.empty() || !m_inputs.push(event)) {
+    m_overflow.push_back(event);
+  }
+}
+
+void SimulationThread::flush() {
+  std::size_t sent{0};
+  while (sent < m_overflow.size() && m_inputs.push(m_overflow[sent])) {
+    ++sent;
+  }
+  m_overflow.erase(m_overflow.begin(),
+                   m_overflow.begin() + static_cast<std::ptrdiff_t>(sent));
+}
+
+const SimulationSnapshot &SimulationThread::acquire() {
+  m_snapshots.update();
+  return m_snapshots.front();
+}
+
+float SimulationThread::alpha() const {
+  const std::chrono::duration<float> elapsed{
+      std::chrono::steady_clock::now() - m_snapshots.front().m_time};
+  return std::clamp(elapsed.count() / m_deltaTime, 0.0f, 1.0f);
+}
+
+void SimulationThread::run() {
+  using Clock = std::chrono::steady_clock;
+  const std::chrono::duration<float> step{m_deltaTime};
+  const auto stepDuration{std::chrono::duration_cast<Clock::duration>(step)};
+
+  auto next{Clock::now()};
+  while (m_running.load(std::memory_order_relaxed)) {
+    InputEvent event;
+    while (m_inputs.pop(event)) {
+      m_simulation->handleInput(event);
+    }
+
+    m_simulation->update(m_deltaTime);
+
+    m_snapshots.back().capture(*m_simulation);
+    m_snapshots.publish();
+
+    // Dorme ate o proximo passo; depois de um atraso grande (ex.: a maquina
+    // suspensa) recomeca a contagem em vez de tentar alcancar o tempo perdido
+    next += stepDuration;
+    const auto now{Clock::now()};
+    if (now - next > std::chrono::milliseconds{250}) {
+      next = now;
+    }
+    std::this_thread::sleep_until(next);
+  }
+}
@@ -0,0 +1,70 @@
+#ifndef SIMULATIONTHREAD_HPP_
+#define SIMULATIONTHREAD_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "concurrency.hpp"
+#include "simulation.hpp"
+
+// Copia imutavel do estado que o renderizador e a interface leem
+struct SimulationSnapshot {
+  GameData m_gameData;
+  CatState m_cat;
+  AsteroidPool m_asteroids;
+  int m_pedras_desviadas{};
+  float m_remainingTime{};
+  std::chrono::steady_clock::time_point m_time;
+
+  void capture(const Simulation &simulation);
+};
+
+// Executa a Simulation em uma thread propria, no passo fixo dela. O estado e
+// publicado a cada passo em um buffer triplo e as entradas chegam por uma
+// fila SPSC, entao a thread de renderizacao nunca espera pela simulacao.
+// Enquanto a thread roda, a Simulation nao deve ser acessada diretamente
+class SimulationThread {
+ public:
+  SimulationThread() = default;
+  SimulationThread(const SimulationThread &) = delete;
+  SimulationThread &operator=(const SimulationThread &) = delete;
+  ~SimulationThread() { stop(); }
+
+  void start(Simulation &simulation);
+  void stop();
+  [[nodiscard]] bool running() const { return m_thread.joinable(); }
+
+  // Envia a entrada pela fila. Com a fila cheia, ela (e as seguintes, para
+  // manter a ordem) espera em m_overflow pelo proximo flush(): nenhuma
+  // entrada e descartada (um KeyUp perdido deixaria o gato andando)
+  void push(const InputEvent &event);
+  // Reenvia as entradas em espera enquanto houver espaco na fila. Chamado a
+  // cada quadro pela thread de renderizacao
+  void flush();
+
+  // Pega o snapshot mais recente (se houver um novo) e o devolve
+  const SimulationSnapshot &acquire();
+  [[nodiscard]] const SimulationSnapshot &snapshot() const {
+    return m_snapshots.front();
+  }
+  // Fracao do passo seguinte ja decorrida desde o snapshot atual
+  [[nodiscard]] float alpha() const;
+
+ private:
+  Simulation *m_simulation{};
+  float m_deltaTime{};
+
+  std::thread m_thread;
+  std::atomic<bool> m_running{false};
+
+  TripleBuffer<SimulationSnapshot> m_snapshots;
+  SpscQueue<InputEvent, 256> m_inputs;
+  // Entradas que nao couberam na fila; so acessadas pela thread produtora
+  std::vector<InputEvent> m_overflow;
+
+  void run();
+};
+
+#endif
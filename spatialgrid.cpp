@@ -0,0 +1,129 @@
+#include "spatialgrid.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+void SpatialGrid::initialize(glm::vec2 min, glm::vec2 max, float cellSize) {
+  m_min = min;
+  m_cellSize = cellSize;
+  m_columns = std::max(1, static_cast<int>(std::ceil((max.x - min.x) /
+                                                      cellSize)));
+  m_rows = std::max(1, static_cast<int>(std::ceil((max.y - min.y) /
+                                                   cellSize)));
+
+  m_cells.resize(static_cast<std::size_t>(m_columns) * m_rows);
+  clear();
+}
+
+// Esvazia a grade mantendo a memoria ja alocada
+void SpatialGrid::clear() {
+  for (auto &cell : m_cells) {
+    cell.clear();
+  }
+  for (auto &body : m_bodies) {
+    body.m_cell = -1;
+  }
+  m_maxRadius = 0.0f;
+}
+
+void SpatialGrid::reserve(std::size_t capacity) {
+  m_bodies.reserve(capacity);
+  for (auto &cell : m_cells) {
+    cell.reserve(capacity);
+  }
+}
+
+void SpatialGrid::insert(std::uint32_t id, glm::vec2 center, float radius) {
+  if (id >= m_bodies.size()) {
+    m_bodies.resize(id + 1);
+  }
+  if (contains(id)) {
+    unlink(id);
+  }
+
+  auto &body{m_bodies[id]};
+  body.m_center = center;
+  body.m_radius = radius;
+  m_maxRadius = std::max(m_maxRadius, radius);
+
+  link(id, cellOf(center));
+}
+
+// Atualizacao incremental: so troca de celula quando o centro muda de celula
+void SpatialGrid::move(std::uint32_t id, glm::vec2 center) {
+  auto &body{m_bodies[id]};
+  body.m_center = center;
+
+  const auto cell{cellOf(center)};
+  if (cell != body.m_cell) {
+    unlink(id);
+    link(id, cell);
+  }
+}
+
+void SpatialGrid::remove(std::uint32_t id) {
+  if (contains(id)) {
+    unlink(id);
+  }
+}
+
+void SpatialGrid::query(glm::vec2 center, float radius,
+                        std::vector<std::uint32_t> &result) const {
+  result.clear();
+  forEachOverlap(center, radius,
+                 [&](std::uint32_t id) { result.push_back(id); });
+}
+
+void SpatialGrid::candidates(glm::vec2 center, float radius,
+                             std::vector<std::uint32_t> &ids,
+                             std::vector<glm::vec2> &centers,
+                             std::vector<float> &radii) const {
+  ids.clear();
+  centers.clear();
+  radii.clear();
+  const auto reach{radius + m_maxRadius};
+  const auto firstColumn{column(center.x - reach)};
+  const auto lastColumn{column(center.x + reach)};
+  const auto firstRow{row(center.y - reach)};
+  const auto lastRow{row(center.y + reach)};
+
+  for (auto r{firstRow}; r <= lastRow; ++r) {
+    for (auto c{firstColumn}; c <= lastColumn; ++c) {
+      for (const auto id : m_cells[r * m_columns + c]) {
+        ids.push_back(id);
+        centers.push_back(m_bodies[id].m_center);
+        radii.push_back(m_bodies[id].m_radius);
+      }
+    }
+  }
+}
+
+int SpatialGrid::column(float x) const {
+  const auto c{static_cast<int>(std::floor((x - m_min.x) / m_cellSize))};
+  return std::clamp(c, 0, m_columns - 1);
+}
+
+int SpatialGrid::row(float y) const {
+  const auto r{static_cast<int>(std::floor((y - m_min.y) / m_cellSize))};
+  return std::clamp(r, 0, m_rows - 1);
+}
+
+void SpatialGrid::link(std::uint32_t id, int cell) {
+  auto &ids{m_cells[cell]};
+  m_bodies[id].m_cell = cell;
+  m_bodies[id].m_slotInCell = static_cast<std::uint32_t>(ids.size());
+  ids.push_back(id);
+}
+
+// Remove o id da sua celula com swap-and-pop
+void SpatialGrid::unlink(std::uint32_t id) {
+  auto &body{m_bodies[id]};
+  auto &ids{m_cells[body.m_cell]};
+
+  const auto moved{ids.back()};
+  ids[body.m_slotInCell] = moved;
+  m_bodies[moved].m_slotInCell = body.m_slotInCell;
+  ids.pop_back();
+
+  body.m_cell = -1;
+}
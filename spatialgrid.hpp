@@ -0,0 +1,99 @@
+#ifndef SPATIALGRID_HPP_
+#define SPATIALGRID_HPP_
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+// Grade uniforme sobre o campo de jogo para consultas do tipo "quais corpos
+// sobrepoem este circulo". Cada corpo (identificado por um id estavel, ex.:
+// o slot do AsteroidPool) fica na celula do seu centro; as consultas
+// expandem a busca pelo maior raio inserido. Posicoes fora dos limites sao
+// presas nas celulas da borda
+class SpatialGrid {
+ public:
+  void initialize(glm::vec2 min, glm::vec2 max, float cellSize);
+  void clear();
+  // Depois do reserve(), corpos com id < capacity nao alocam memoria, mesmo
+  // que todos caiam na mesma celula
+  void reserve(std::size_t capacity);
+
+  void insert(std::uint32_t id, glm::vec2 center, float radius);
+  void move(std::uint32_t id, glm::vec2 center);
+  void remove(std::uint32_t id);
+
+  // Chama fn(id) para cada corpo cujo circulo sobrepoe (center, radius)
+  template <typename Fn>
+  void forEachOverlap(glm::vec2 center, float radius, Fn &&fn) const;
+  void query(glm::vec2 center, float radius,
+             std::vector<std::uint32_t> &result) const;
+  // Corpos de todas as celulas ao alcance de (center, radius), sem o teste
+  // de distancia: ids, centros e raios em arrays densos, para o chamador
+  // fazer o teste exato de uma vez (ex.: com overlapCircles)
+  void candidates(glm::vec2 center, float radius,
+                  std::vector<std::uint32_t> &ids,
+                  std::vector<glm::vec2> &centers,
+                  std::vector<float> &radii) const;
+
+  [[nodiscard]] bool contains(std::uint32_t id) const {
+    return id < m_bodies.size() && m_bodies[id].m_cell >= 0;
+  }
+  [[nodiscard]] glm::vec2 center(std::uint32_t id) const {
+    return m_bodies[id].m_center;
+  }
+  [[nodiscard]] float radius(std::uint32_t id) const {
+    return m_bodies[id].m_radius;
+  }
+
+ private:
+  struct Body {
+    glm::vec2 m_center{};
+    float m_radius{};
+    int m_cell{-1};
+    std::uint32_t m_slotInCell{};
+  };
+
+  glm::vec2 m_min{-1.0f};
+  float m_cellSize{0.25f};
+  int m_columns{8};
+  int m_rows{8};
+  float m_maxRadius{};
+
+  std::vector<std::vector<std::uint32_t>> m_cells;
+  std::vector<Body> m_bodies;
+
+  [[nodiscard]] int column(float x) const;
+  [[nodiscard]] int row(float y) const;
+  [[nodiscard]] int cellOf(glm::vec2 position) const {
+    return row(position.y) * m_columns + column(position.x);
+  }
+  void link(std::uint32_t id, int cell);
+  void unlink(std::uint32_t id);
+};
+
+template <typename Fn>
+void SpatialGrid::forEachOverlap(glm::vec2 center, float radius,
+                                 Fn &&fn) const {
+  const auto reach{radius + m_maxRadius};
+  const auto firstColumn{column(center.x - reach)};
+  const auto lastColumn{column(center.x + reach)};
+  const auto firstRow{row(center.y - reach)};
+  const auto lastRow{row(center.y + reach)};
+
+  for (auto r{firstRow}; r <= lastRow; ++r) {
+    for (auto c{firstColumn}; c <= lastColumn; ++c) {
+      for (const auto id : m_cells[r * m_columns + c]) {
+        const auto &body{m_bodies[id]};
+        const auto offset{body.m_center - center};
+        const auto distance{radius + body.m_radius};
+        // Compara distancias ao quadrado para evitar a raiz
+        if (offset.x * offset.x + offset.y * offset.y < distance * distance) {
+          fn(id);
+        }
+      }
+    }
+  }
+}
+
+#endif
@@ -2,94 +2,173 @@
 
 #include <cppitertools/itertools.hpp>
 
-void StarLayers::initializeGL(GLuint program, int quantity) {
+#include <string>
+
+void StarLayers::initializeGL(GLuint program, GLuint proceduralProgram,
+                              int quantity, unsigned seed) {
   terminateGL();
 
   // Inicia um contador com numeros pseudo aleatorios
-  m_randomEngine.seed(
-      std::chrono::steady_clock::now().time_since_epoch().count());
+  m_seed = seed;
+  m_randomEngine.seed(seed);
 
   m_program = program;
   m_pointSizeLoc = abcg::glGetUniformLocation(m_program, "pointSize");
-  m_translationLoc = abcg::glGetUniformLocation(m_program, "translation");
-
-  auto &re{m_randomEngine};
-  std::uniform_real_distribution<float> distPos(-1.0f, 1.0f);
-  std::uniform_real_distribution<float> distIntensity(0.5f, 1.0f);
-
-  for (auto &&[index, layer] : iter::enumerate(m_starLayers)) {
-    layer.m_pointSize = 10.0f / (1.0f + index);
-    layer.m_quantity = quantity * (static_cast<int>(index) + 1);
-    layer.m_translation = glm::vec2(0);
-
-    std::vector<glm::vec3> data(0);
-    for ([[maybe_unused]] auto i : iter::range(0, layer.m_quantity)) {
-      data.emplace_back(distPos(re), distPos(re), 0);
-      data.push_back(glm::vec3(1) * distIntensity(re));
-    }
+  m_scrollLoc = abcg::glGetUniformLocation(m_program, "scroll");
+
+  m_layerQuantity = quantity;
+  generateStars();
+
+  // Cria VBO
+  m_vbo = GLBuffer{GLResourceRegistry::Owner::Stars};
+  abcg::glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+  bufferData(m_vbo, GL_ARRAY_BUFFER, m_data.size() * sizeof(glm::vec3),
+             m_data.data(), GL_STATIC_DRAW);
+  abcg::glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  // Obtem a localização dos atributos no programa
+  GLint positionAttribute{abcg::glGetAttribLocation(m_program, "inPosition")};
+  GLint colorAttribute{abcg::glGetAttribLocation(m_program, "inColor")};
+
+  // Cria VAO
+  m_vao = GLVertexArray{GLResourceRegistry::Owner::Stars};
+
+  // Vincular atributos de vértice ao VAO atual
+  abcg::glBindVertexArray(m_vao);
+
+  abcg::glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+  abcg::glEnableVertexAttribArray(positionAttribute);
+  abcg::glVertexAttribPointer(positionAttribute, 3, GL_FLOAT, GL_FALSE,
+                              sizeof(glm::vec3) * 2, nullptr);
+  abcg::glEnableVertexAttribArray(colorAttribute);
+  abcg::glVertexAttribPointer(colorAttribute, 3, GL_FLOAT, GL_FALSE,
+                              sizeof(glm::vec3) * 2,
+                              reinterpret_cast<void *>(sizeof(glm::vec3)));
+  abcg::glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  // Fim da ligação ao VAO atual
+  abcg::glBindVertexArray(0);
+
+  // Campo procedural: os vertices sao gerados em stars.vert
+  m_proceduralProgram = proceduralProgram;
+  for (const auto layer : iter::range(m_layerCount)) {
+    const auto name{"layers[" + std::to_string(layer) + "]"};
+    m_layerLocs.at(layer) =
+        abcg::glGetUniformLocation(m_proceduralProgram, name.c_str());
+  }
+  m_proceduralScrollLoc =
+      abcg::glGetUniformLocation(m_proceduralProgram, "scroll");
+  m_seedLoc = abcg::glGetUniformLocation(m_proceduralProgram, "seed");
+  m_emptyVao = GLVertexArray{GLResourceRegistry::Owner::Stars};
+}
 
-    // Cria VBO
-    abcg::glGenBuffers(1, &layer.m_vbo);
-    abcg::glBindBuffer(GL_ARRAY_BUFFER, layer.m_vbo);
-    abcg::glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(glm::vec3),
-                       data.data(), GL_STATIC_DRAW);
-    abcg::glBindBuffer(GL_ARRAY_BUFFER, 0);
+// No campo procedural, trocar a semente basta; os pontos sao sorteados de
+// novo quando voltarem a ser usados
+void StarLayers::reset(unsigned seed) {
+  m_seed = seed;
+  if (m_procedural) return;
 
-    // Obtem a localização dos atributos no programa
-    GLint positionAttribute{abcg::glGetAttribLocation(m_program, "inPosition")};
-    GLint colorAttribute{abcg::glGetAttribLocation(m_program, "inColor")};
+  m_randomEngine.seed(seed);
+  generateStars();
 
-    // Cria VAO
-    abcg::glGenVertexArrays(1, &layer.m_vao);
+  // Mesmo numero de estrelas: sobrescreve o VBO no lugar
+  abcg::glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+  bufferSubData(m_vbo, GL_ARRAY_BUFFER, 0, m_data.size() * sizeof(glm::vec3),
+                m_data.data());
+  abcg::glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
 
-    // Vincular atributos de vértice ao VAO atual
-    abcg::glBindVertexArray(layer.m_vao);
+void StarLayers::setDensity(int quantity) {
+  if (quantity == m_layerQuantity) return;
+  m_layerQuantity = quantity;
+  if (!m_procedural) rebuild();
+}
 
-    abcg::glBindBuffer(GL_ARRAY_BUFFER, layer.m_vbo);
-    abcg::glEnableVertexAttribArray(positionAttribute);
-    abcg::glVertexAttribPointer(positionAttribute, 2, GL_FLOAT, GL_FALSE,
-                                sizeof(glm::vec3) * 2, nullptr);
-    abcg::glEnableVertexAttribArray(colorAttribute);
-    abcg::glVertexAttribPointer(colorAttribute, 3, GL_FLOAT, GL_FALSE,
-                                sizeof(glm::vec3) * 2,
-                                reinterpret_cast<void *>(sizeof(glm::vec3)));
+void StarLayers::cycleMode() {
+  if (!m_procedural) {
+    // O VBO dos pontos fica sem armazenamento enquanto nao e usado
+    m_procedural = true;
+    m_densityTier = 0;
+    abcg::glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    bufferData(m_vbo, GL_ARRAY_BUFFER, 0, nullptr, GL_STATIC_DRAW);
     abcg::glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-    // Fim da ligação ao VAO atual
-    abcg::glBindVertexArray(0);
+  } else if (m_densityTier + 1 < m_densityTiers.size()) {
+    ++m_densityTier;
+  } else {
+    m_procedural = false;
+    m_randomEngine.seed(m_seed);
+    rebuild();
   }
 }
 
-void StarLayers::paintGL() {
-  abcg::glUseProgram(m_program);
-
-  abcg::glEnable(GL_BLEND);
-  abcg::glBlendFunc(GL_ONE, GL_ONE);
+// O tamanho do VBO muda: realoca o armazenamento (o VAO continua valido)
+void StarLayers::rebuild() {
+  generateStars();
 
-  for (const auto &layer : m_starLayers) {
-    abcg::glBindVertexArray(layer.m_vao);
-    abcg::glUniform1f(m_pointSizeLoc, layer.m_pointSize);
+  abcg::glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+  bufferData(m_vbo, GL_ARRAY_BUFFER, m_data.size() * sizeof(glm::vec3),
+             m_data.data(), GL_STATIC_DRAW);
+  abcg::glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
 
-    for (const auto i : {-2, 0, 2}) {
-      for (const auto j : {-2, 0, 2}) {
-        abcg::glUniform2f(m_translationLoc, layer.m_translation.x + j,
-                          layer.m_translation.y + i);
+// A camada i tem m_layerQuantity * (i + 1) estrelas. Depois da primeira
+// chamada, m_data ja tem a capacidade necessaria e nao aloca mais
+void StarLayers::generateStars() {
+  auto &re{m_randomEngine};
+  std::uniform_real_distribution<float> distPos(-1.0f, 1.0f);
+  std::uniform_real_distribution<float> distIntensity(0.5f, 1.0f);
 
-        abcg::glDrawArrays(GL_POINTS, 0, layer.m_quantity);
-      }
+  m_data.clear();
+  m_quantity = 0;
+  for (const auto layer : iter::range(m_layerCount)) {
+    for ([[maybe_unused]] auto i :
+         iter::range(0, m_layerQuantity * (layer + 1))) {
+      m_data.emplace_back(distPos(re), distPos(re), static_cast<float>(layer));
+      m_data.push_back(glm::vec3(1) * distIntensity(re));
     }
+    m_quantity += m_layerQuantity * (layer + 1);
+  }
+}
 
-    abcg::glBindVertexArray(0);
+void StarLayers::paintGL(RenderQueue &queue) {
+  // Deslocamento da camada mais proxima; o shader divide por (1 + camada) e
+  // repete as estrelas que saem do campo [-1, 1]
+  const auto scroll{m_scrollVelocity * m_time};
+  if (m_procedural) {
+    paintProcedural(queue, scroll);
+    return;
   }
 
-  abcg::glDisable(GL_BLEND);
+  auto &packet{queue.submit(RenderQueue::Layer::Stars, m_program, m_vao,
+                            BlendMode::Additive)};
+  packet.m_mode = GL_POINTS;
+  packet.m_count = m_quantity;
+  queue.uniform(m_pointSizeLoc, m_pointSize);
+  queue.uniform(m_scrollLoc, scroll);
+}
 
-  abcg::glUseProgram(0);
+// Mesmas camadas dos pontos: a camada i tem (i + 1) vezes mais estrelas,
+// pontos de m_pointSize / (1 + i) pixels e rola na mesma proporcao
+void StarLayers::paintProcedural(RenderQueue &queue, glm::vec2 scroll) const {
+  auto &packet{queue.submit(RenderQueue::Layer::Stars, m_proceduralProgram,
+                            m_emptyVao, BlendMode::Additive)};
+  packet.m_count = 3;
+
+  const auto tier{m_densityTiers.at(m_densityTier)};
+  for (const auto layer : iter::range(m_layerCount)) {
+    const auto depth{1.0f + static_cast<float>(layer)};
+    const auto density{m_layerQuantity * (layer + 1) * tier};
+    queue.uniform(m_layerLocs.at(layer),
+                  glm::vec4{static_cast<float>(density), m_pointSize / depth,
+                            1.0f / depth, 0.0f});
+  }
+  queue.uniform(m_proceduralScrollLoc, scroll);
+  // 16 bits: exatos em um float
+  queue.uniform(m_seedLoc, static_cast<float>(m_seed & 0xffffu));
 }
 
 void StarLayers::terminateGL() {
-  for (auto &layer : m_starLayers) {
-    abcg::glDeleteBuffers(1, &layer.m_vbo);
-    abcg::glDeleteVertexArrays(1, &layer.m_vao);
-  }
-}
\ No newline at end of file
+  m_vbo.reset();
+  m_vao.reset();
+  m_emptyVao.reset();
+}
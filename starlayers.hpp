@@ -2,39 +2,84 @@
 #define STARLAYERS_HPP_
 
 #include <array>
+#include <cstddef>
 #include <random>
+#include <vector>
 
 #include "abcg.hpp"
 #include "cat.hpp"
 #include "gamedata.hpp"
+#include "glresource.hpp"
+#include "renderqueue.hpp"
 
 class OpenGLWindow;
 
+// Estrelas de 5 camadas em um unico VBO, desenhadas com um so draw call. O
+// indice da camada vai na coordenada z de cada estrela; a rolagem (com
+// paralaxe por camada) e a repeticao nas bordas sao feitas em stars.vert.
+// Alternativa (m_procedural): um unico triangulo de tela inteira, com as
+// estrelas calculadas em stars.frag (variante PROCEDURAL) a partir de uma
+// grade de celulas com hash. Nao usa memoria de vertices, o custo nao
+// depende do numero de estrelas e trocar a semente basta para regenera-las
 class StarLayers {
  public:
-  void initializeGL(GLuint program, int quantity);
-  void paintGL();
+  void initializeGL(GLuint program, GLuint proceduralProgram, int quantity,
+                    unsigned seed);
+  void paintGL(RenderQueue &queue);
   void terminateGL();
 
+  // Sorteia novas estrelas no VBO existente (sem criar objetos OpenGL)
+  void reset(unsigned seed);
+  // Troca o numero de estrelas por camada (qualidade adaptativa)
+  void setDensity(int quantity);
+  [[nodiscard]] int density() const { return m_layerQuantity; }
+
+  // Pontos -> procedural em cada nivel de densidade -> pontos
+  void cycleMode();
+
+  void update(float deltaTime) { m_time += deltaTime; }
+
  private:
   friend OpenGLWindow;
 
   GLuint m_program{};
   GLint m_pointSizeLoc{};
-  GLint m_translationLoc{};
+  GLint m_scrollLoc{};
+
+  GLVertexArray m_vao;
+  GLBuffer m_vbo;
 
-  struct StarLayer {
-    GLuint m_vao{};
-    GLuint m_vbo{};
+  static constexpr int m_layerCount{5};
+  int m_quantity{};
+  int m_layerQuantity{};
 
-    float m_pointSize{};
-    int m_quantity{};
-    glm::vec2 m_translation{glm::vec2(0)};
-  };
+  // Campo procedural: o VAO vazio so existe porque o perfil core exige um
+  bool m_procedural{false};
+  GLuint m_proceduralProgram{};
+  std::array<GLint, m_layerCount> m_layerLocs{};
+  GLint m_proceduralScrollLoc{};
+  GLint m_seedLoc{};
+  GLVertexArray m_emptyVao;
 
-  std::array<StarLayer, 5> m_starLayers;
+  // Multiplicador das estrelas por camada no campo procedural
+  static constexpr std::array m_densityTiers{1, 4, 16, 64};
+  std::size_t m_densityTier{};
+  unsigned m_seed{};
+
+  // Posicao (z = camada) e cor de cada estrela, reaproveitado no reset()
+  std::vector<glm::vec3> m_data;
+
+  // Tamanho dos pontos da camada mais proxima; a camada i usa
+  // m_pointSize / (1 + i) e rola na mesma proporcao
+  float m_pointSize{10.0f};
+  glm::vec2 m_scrollVelocity{0.0f, -0.05f};
+  float m_time{};
 
   std::default_random_engine m_randomEngine;
+
+  void generateStars();
+  void rebuild();
+  void paintProcedural(RenderQueue &queue, glm::vec2 scroll) const;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,128 @@
+#include "streambuffer.hpp"
+
+#include <algorithm>
+#include <utility>
+
+void StreamBuffer::initializeGL(GLsizeiptr regionSize) {
+  terminateGL();
+
+  m_regionSize = regionSize;
+  m_region = 0;
+  m_offset = 0;
+
+  m_buffer = GLBuffer{GLResourceRegistry::Owner::Stream};
+  abcg::glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+  bufferData(m_buffer, GL_ARRAY_BUFFER, m_regionSize * m_regionCount, nullptr,
+             GL_STREAM_DRAW);
+  abcg::glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void StreamBuffer::terminateGL() {
+  for (auto &fence : m_fences) {
+    if (fence != nullptr) {
+      abcg::glDeleteSync(fence);
+      fence = nullptr;
+    }
+  }
+  m_buffer.reset();
+  m_retired.reset();
+  m_isMapped = false;
+}
+
+// Passa para a proxima regiao, esperando a GPU liberar a regiao se ela ainda
+// estiver em uso (so acontece com mais de tres quadros na fila)
+void StreamBuffer::beginFrame() {
+  m_retired.reset();
+  m_region = (m_region + 1) % m_regionCount;
+  m_offset = 0;
+
+  auto &fence{m_fences[m_region]};
+  if (fence != nullptr) {
+    while (abcg::glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                  1'000'000) == GL_TIMEOUT_EXPIRED) {
+    }
+    abcg::glDeleteSync(fence);
+    fence = nullptr;
+  }
+}
+
+// Marca a regiao deste quadro como em uso ate a GPU executar os draws
+void StreamBuffer::endFrame() {
+#if !defined(__EMSCRIPTEN__)
+  if (m_offset == 0) return;
+  m_fences[m_region] = abcg::glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+#endif
+}
+
+StreamBuffer::Slice StreamBuffer::map(GLsizeiptr size, GLsizeiptr alignment) {
+  auto offset{(m_offset + alignment - 1) / alignment * alignment};
+  if (offset + size > m_regionSize) {
+    grow(size);
+    offset = 0;
+  }
+
+  m_mapped.m_buffer = m_buffer;
+  m_mapped.m_offset = regionStart() + offset;
+  m_mapped.m_size = size;
+  m_offset = offset + size;
+
+  abcg::glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+  m_mapped.m_data = nullptr;
+#if !defined(__EMSCRIPTEN__)
+  // A regiao ja foi liberada pelo fence em beginFrame(), entao o driver nao
+  // precisa sincronizar nada
+  m_mapped.m_data = abcg::glMapBufferRange(
+      GL_ARRAY_BUFFER, m_mapped.m_offset, size,
+      GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT |
+          GL_MAP_INVALIDATE_RANGE_BIT);
+#endif
+  m_usingStaging = m_mapped.m_data == nullptr;
+  if (m_usingStaging) {
+    m_staging.resize(static_cast<std::size_t>(size));
+    m_mapped.m_data = m_staging.data();
+  }
+  m_isMapped = true;
+
+  return m_mapped;
+}
+
+void StreamBuffer::unmap() {
+  if (!m_isMapped) return;
+
+  if (m_usingStaging) {
+    bufferSubData(m_buffer, GL_ARRAY_BUFFER, m_mapped.m_offset,
+                  m_mapped.m_size, m_staging.data());
+  } else {
+    abcg::glUnmapBuffer(GL_ARRAY_BUFFER);
+    m_buffer.uploaded(static_cast<std::size_t>(m_mapped.m_size));
+  }
+  abcg::glBindBuffer(GL_ARRAY_BUFFER, 0);
+  m_isMapped = false;
+}
+
+// A regiao nao comporta o pedido: passa a usar um buffer novo e maior. Os
+// draws sao adiados pela RenderQueue, entao pacotes deste quadro ainda
+// apontam para fatias do buffer atual; realoca-lo (orphaning) faria esses
+// draws lerem o armazenamento novo, nao inicializado. O buffer atual fica
+// intacto em m_retired ate o proximo beginFrame(), depois que a fila foi
+// executada (o GL adia a exclusao enquanto a GPU ainda o usa). Os fences
+// protegiam regioes do buffer antigo e podem ser descartados
+void StreamBuffer::grow(GLsizeiptr size) {
+  for (auto &fence : m_fences) {
+    if (fence != nullptr) {
+      abcg::glDeleteSync(fence);
+      fence = nullptr;
+    }
+  }
+
+  m_regionSize = std::max(m_regionSize * 2, size);
+  m_region = 0;
+  m_offset = 0;
+
+  m_retired = std::move(m_buffer);
+  m_buffer = GLBuffer{GLResourceRegistry::Owner::Stream};
+  abcg::glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+  bufferData(m_buffer, GL_ARRAY_BUFFER, m_regionSize * m_regionCount, nullptr,
+             GL_STREAM_DRAW);
+  abcg::glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
@@ -0,0 +1,64 @@
+#ifndef STREAMBUFFER_HPP_
+#define STREAMBUFFER_HPP_
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "abcg.hpp"
+#include "glresource.hpp"
+
+// Buffer de streaming para dados que mudam a cada quadro (transformacoes,
+// cores, instancias). O VBO e dividido em tres regioes usadas em rodizio
+// (uma por quadro); cada regiao e protegida por um fence, entao a CPU so
+// escreve em uma regiao depois que a GPU terminou os draws de tres quadros
+// atras. Cada modulo pede uma fatia com map(), escreve direto na memoria
+// mapeada (glMapBufferRange sem sincronizacao) e chama unmap() antes do draw.
+// No WebGL, sem glMapBufferRange, a fatia aponta para memoria da CPU e e
+// enviada com glBufferSubData no unmap()
+class StreamBuffer {
+ public:
+  struct Slice {
+    void *m_data{};
+    // Buffer da fatia: pode mudar entre fatias do mesmo quadro (grow())
+    GLuint m_buffer{};
+    GLintptr m_offset{};
+    GLsizeiptr m_size{};
+  };
+
+  void initializeGL(GLsizeiptr regionSize);
+  void terminateGL();
+
+  void beginFrame();
+  void endFrame();
+
+  // A fatia so e valida ate o unmap()
+  Slice map(GLsizeiptr size, GLsizeiptr alignment = 16);
+  void unmap();
+
+  [[nodiscard]] GLuint buffer() const { return m_buffer; }
+
+ private:
+  static constexpr std::size_t m_regionCount{3};
+
+  GLBuffer m_buffer;
+  // Buffer substituido por grow() neste quadro, liberado no proximo
+  GLBuffer m_retired;
+  GLsizeiptr m_regionSize{};
+  std::size_t m_region{};
+  GLintptr m_offset{};
+  std::array<GLsync, m_regionCount> m_fences{};
+
+  Slice m_mapped;
+  bool m_isMapped{false};
+  // Usado quando nao ha glMapBufferRange (WebGL) ou o mapeamento falha
+  std::vector<unsigned char> m_staging;
+  bool m_usingStaging{false};
+
+  void grow(GLsizeiptr size);
+  [[nodiscard]] GLintptr regionStart() const {
+    return static_cast<GLintptr>(m_region) * m_regionSize;
+  }
+};
+
+#endif